@@ -213,11 +213,23 @@ which are async signal safe, and which are not.
 #define WG14_SIGNALS_GETTID() syscall(SYS_gettid)
 #endif
 
+//! \brief `WG14_SIGNALS_GETCPU(cpu)` routes the current-CPU query used by
+//! per-CPU `tss_async_signal_safe` instances on Linux when the C library has
+//! not registered a restartable sequence area with the kernel (from which the
+//! CPU is read directly). It stores the CPU number into `*cpu`, an `unsigned
+//! *`, and returns zero on success. The default is the `SYS_getcpu` syscall.
+//! The replacement must be async-signal-safe and thread-safe (it runs inside
+//! signal handlers).
+#ifndef WG14_SIGNALS_GETCPU
+#define WG14_SIGNALS_GETCPU(cpu)                                               \
+  syscall(SYS_getcpu, (cpu), WG14_SIGNALS_NULLPTR, WG14_SIGNALS_NULLPTR)
+#endif
+
 //! \brief Embedder override hooks for the remaining host calls (the
 //! "OS abstraction layer" call-site families, part 2).
 //!
 //! Besides sigaction/abort/pthread_kill(pthread_self(), ...)/gettid, the
-//! POSIX backend calls the C library's memory, sigset, setjmp and
+//! POSIX backend calls the C library's memory, sorting, sigset, setjmp and
 //! pthread-key functions by name. An embedding standard C library whose
 //! public entrypoints are the very registry being replaced (or whose
 //! internal build provides only C++-linkage symbols for them, as
@@ -240,6 +252,10 @@ which are async signal safe, and which are not.
 #ifndef WG14_SIGNALS_FREE
 #define WG14_SIGNALS_FREE(p) free(p)
 #endif
+#ifndef WG14_SIGNALS_QSORT
+#define WG14_SIGNALS_QSORT(base, n, size, compar)                              \
+  qsort((base), (n), (size), (compar))
+#endif
 #ifndef WG14_SIGNALS_SIGEMPTYSET
 #define WG14_SIGNALS_SIGEMPTYSET(set) sigemptyset(set)
 #endif
@@ -269,21 +285,74 @@ which are async signal safe, and which are not.
 #ifndef WG14_SIGNALS_PTHREAD_GETSPECIFIC
 #define WG14_SIGNALS_PTHREAD_GETSPECIFIC(key) pthread_getspecific(key)
 #endif
+//! \brief Whether a guarded frame saves a compact recovery context instead of
+//! a `jmp_buf` (POSIX only; defaults to off).
+//!
+//! Every sigguarded() with a recovery function captures its context on the
+//! caller's stack, and a glibc x86-64 `jmp_buf` is 200 bytes, most of it
+//! signal mask storage `_setjmp()` never uses. When this is 1 the frame keeps
+//! only the five words GCC's and clang's `__builtin_setjmp()` save (frame
+//! pointer, resume address and stack pointer), the compiler spilling the
+//! callee-saved registers in the guarding function itself, which makes the
+//! whole frame fit in two cache lines. It needs GCC or clang, and as
+//! `__builtin_longjmp()` is not intercepted by AddressSanitizer, a sanitised
+//! build may report false positives on the stack it unwinds.
+#ifndef WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT
+#define WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT 0
+#endif
+#if WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT && !defined(_WIN32) &&              \
+!defined(__GNUC__)
+#error "WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT needs GCC or clang"
+#endif
 #ifndef WG14_SIGNALS_SETJMP
-#if WG14_SIGNALS_HAVE__SETJMP
+#if WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT && !defined(_WIN32)
+#define WG14_SIGNALS_SETJMP(buf) __builtin_setjmp(buf)
+#elif WG14_SIGNALS_HAVE__SETJMP
 #define WG14_SIGNALS_SETJMP(buf) _setjmp(buf)
 #else
 #define WG14_SIGNALS_SETJMP(buf) setjmp(buf)
 #endif
 #endif
 #ifndef WG14_SIGNALS_LONGJMP
-#if WG14_SIGNALS_HAVE__SETJMP
+#if WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT && !defined(_WIN32)
+// __builtin_longjmp() only accepts a value of 1.
+#define WG14_SIGNALS_LONGJMP(buf, val) __builtin_longjmp((buf), 1)
+#elif WG14_SIGNALS_HAVE__SETJMP
 #define WG14_SIGNALS_LONGJMP(buf, val) _longjmp((buf), (val))
 #else
 #define WG14_SIGNALS_LONGJMP(buf, val) longjmp((buf), (val))
 #endif
 #endif
 
+//! \brief The instruction address in a POSIX signal handler's `ucontext_t *`,
+//! as an lvalue, which sigguarded_regions_register() reads to find the
+//! guarded region and writes to resume at its landing pad. Left undefined
+//! where this library does not know the context layout, which makes region
+//! registration fail with `ENOTSUP`; an embedder may define it for another.
+//! On x86 Linux the register index is named by `<sys/ucontext.h>` only under
+//! the feature-test macros the build probes for, so a consumer testing for
+//! this macro must compile with the same ones as the library.
+#ifndef WG14_SIGNALS_UCONTEXT_PC
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__))
+#include <sys/ucontext.h>
+#endif
+#if defined(__linux__) && defined(__x86_64__) && defined(REG_RIP)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext.gregs[REG_RIP])
+#elif defined(__linux__) && defined(__i386__) && defined(REG_EIP)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext.gregs[REG_EIP])
+#elif defined(__linux__) && defined(__aarch64__)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext.pc)
+#elif defined(__FreeBSD__) && defined(__x86_64__)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext.mc_rip)
+#elif defined(__FreeBSD__) && defined(__aarch64__)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext.mc_gpregs.gp_elr)
+#elif defined(__APPLE__) && defined(__x86_64__)
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext->__ss.__rip)
+#elif defined(__APPLE__) && (defined(__arm64__) || defined(__aarch64__))
+#define WG14_SIGNALS_UCONTEXT_PC(uc) ((uc)->uc_mcontext->__ss.__pc)
+#endif
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -30,6 +30,124 @@ limitations under the License.
 #define WG14_SIGNALS_ATOMIC_PREFIX
 #endif
 
+/* Which lock LOCK()/UNLOCK() implement over an `atomic_uint` (zero is
+unlocked). Define WG14_SIGNALS_LOCK_KIND to one of:
+
+- WG14_SIGNALS_LOCK_KIND_SPIN: the original unbounded compare-exchange spin.
+- WG14_SIGNALS_LOCK_KIND_BACKOFF (the default): test-and-test-and-set, which
+spins on a plain load with CPU relax hints, waiting exponentially longer (up to
+WG14_SIGNALS_LOCK_MAX_BACKOFF relax hints) between attempts, so contended
+waiters stop bouncing the lock's cache line between cores.
+- WG14_SIGNALS_LOCK_KIND_TICKET: a FIFO ticket lock, for fairness under heavy
+contention, with backoff proportional to the waiter's place in the queue. The
+upper 16 bits of the word are the next ticket, the lower 16 bits the ticket now
+served. A waiter has a place in the queue, so a signal handler which takes a
+lock its interrupted thread is queued on deadlocks, where the other kinds let
+the handler barge in. Only select this if no lock is taken from a signal
+handler while its thread can be waiting on it, which with the fallback TLS
+(`WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL=0`) is not the case.
+
+An MCS queue lock would give the same fairness with local spinning, but needs a
+queue node per acquisition threaded from LOCK() to UNLOCK(), which these
+statement macros over a single word cannot carry.
+*/
+#define WG14_SIGNALS_LOCK_KIND_SPIN 0
+#define WG14_SIGNALS_LOCK_KIND_BACKOFF 1
+#define WG14_SIGNALS_LOCK_KIND_TICKET 2
+#ifndef WG14_SIGNALS_LOCK_KIND
+#define WG14_SIGNALS_LOCK_KIND WG14_SIGNALS_LOCK_KIND_BACKOFF
+#endif
+#ifndef WG14_SIGNALS_LOCK_MAX_BACKOFF
+#define WG14_SIGNALS_LOCK_MAX_BACKOFF 64
+#endif
+
+// Tell the CPU this is a spin-wait loop: on x86 this stops the pipeline
+// speculatively issuing loads of the lock word, and yields to a hyperthread.
+#ifndef WG14_SIGNALS_CPU_RELAX
+#if defined(_MSC_VER) && !defined(__clang__) &&                                \
+(defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define WG14_SIGNALS_CPU_RELAX() _mm_pause()
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_ARM64)
+#include <intrin.h>
+#define WG14_SIGNALS_CPU_RELAX() __yield()
+#elif defined(__FILC__)
+#define WG14_SIGNALS_CPU_RELAX() ((void) 0)
+#elif defined(__i386__) || defined(__x86_64__)
+#define WG14_SIGNALS_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define WG14_SIGNALS_CPU_RELAX() __asm__ __volatile__("yield" ::: "memory")
+#else
+#define WG14_SIGNALS_CPU_RELAX() ((void) 0)
+#endif
+#endif
+
+
+#if WG14_SIGNALS_LOCK_KIND == WG14_SIGNALS_LOCK_KIND_TICKET
+#define LOCK(x)                                                                \
+  {                                                                            \
+    const unsigned wg14_lock_ticket = atomic_fetch_add_explicit(               \
+    &(x), 1u << 16, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) >> 16;    \
+    for(;;)                                                                    \
+    {                                                                          \
+      const unsigned wg14_lock_now = atomic_load_explicit(                     \
+      &(x), WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);                  \
+      const unsigned wg14_lock_ahead =                                         \
+      (wg14_lock_ticket - wg14_lock_now) & 0xffffu;                            \
+      if(wg14_lock_ahead == 0)                                                 \
+      {                                                                        \
+        break;                                                                 \
+      }                                                                        \
+      for(unsigned wg14_lock_n = 0; wg14_lock_n < wg14_lock_ahead;             \
+          wg14_lock_n++)                                                       \
+      {                                                                        \
+        WG14_SIGNALS_CPU_RELAX();                                              \
+      }                                                                        \
+    }                                                                          \
+  }
+
+// Advance the ticket now served, without carrying into the next ticket.
+#define UNLOCK(x)                                                              \
+  {                                                                            \
+    unsigned wg14_lock_former = atomic_load_explicit(                          \
+    &(x), WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);                    \
+    while(!atomic_compare_exchange_weak_explicit(                              \
+    &(x), &wg14_lock_former,                                                   \
+    (wg14_lock_former & 0xffff0000u) | ((wg14_lock_former + 1) & 0xffffu),     \
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_release,                           \
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))                          \
+    {                                                                          \
+    }                                                                          \
+    assert((wg14_lock_former >> 16) != (wg14_lock_former & 0xffffu));          \
+  }
+#else
+#if WG14_SIGNALS_LOCK_KIND == WG14_SIGNALS_LOCK_KIND_BACKOFF
+#define LOCK(x)                                                                \
+  for(unsigned wg14_lock_backoff = 1;;)                                        \
+  {                                                                            \
+    if(atomic_load_explicit(&(x),                                              \
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))  \
+    {                                                                          \
+      for(unsigned wg14_lock_n = 0; wg14_lock_n < wg14_lock_backoff;           \
+          wg14_lock_n++)                                                       \
+      {                                                                        \
+        WG14_SIGNALS_CPU_RELAX();                                              \
+      }                                                                        \
+      if(wg14_lock_backoff < WG14_SIGNALS_LOCK_MAX_BACKOFF)                    \
+      {                                                                        \
+        wg14_lock_backoff <<= 1;                                               \
+      }                                                                        \
+      continue;                                                                \
+    }                                                                          \
+    unsigned expected = 0;                                                     \
+    if(atomic_compare_exchange_weak_explicit(                                  \
+       &(x), &expected, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,    \
+       WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))                       \
+    {                                                                          \
+      break;                                                                   \
+    }                                                                          \
+  }
+#else
 #define LOCK(x)                                                                \
   for(;;)                                                                      \
   {                                                                            \
@@ -46,6 +164,7 @@ limitations under the License.
       break;                                                                   \
     }                                                                          \
   }
+#endif
 
 #ifdef NDEBUG
 #define UNLOCK(x)                                                              \
@@ -59,5 +178,6 @@ limitations under the License.
     assert(former == 1);                                                       \
   }
 #endif
+#endif
 
 #endif
@@ -59,9 +59,14 @@ extern "C"
   struct WG14_SIGNALS_PREFIX(sighandler_info);
 
 #if NSIG < 1024
+  // The slots are atomic so that stdc_raise() can look up a signal's container
+  // without taking state->lock: writers (which serialise changes to the map
+  // itself on state->lock) publish a slot with a release store, and the
+  // lock-free raise path reads it with an acquire load inside its read-side
+  // critical section.
   typedef struct WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t)
   {
-    struct WG14_SIGNALS_PREFIX(sighandler_info) * arr[NSIG];
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t arr[NSIG];
   } WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t);
 
   struct WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr_data)
@@ -81,13 +86,18 @@ extern "C"
   WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t) * map, int idx)
   {
     WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr) ret;
-    if(idx < 0 || idx >= NSIG || map->arr[idx] == WG14_SIGNALS_NULLPTR)
+    struct WG14_SIGNALS_PREFIX(sighandler_info) *val =
+    (idx < 0 || idx >= NSIG)
+    ? WG14_SIGNALS_NULLPTR
+    : (struct WG14_SIGNALS_PREFIX(sighandler_info) *) atomic_load_explicit(
+      &map->arr[idx], WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    if(val == WG14_SIGNALS_NULLPTR)
     {
       ret.data_.val = WG14_SIGNALS_NULLPTR;
       ret.data_.idx = (size_t) -1;
       return ret;
     }
-    ret.data_.val = map->arr[idx];
+    ret.data_.val = val;
     ret.data_.idx = idx;
     return ret;
   }
@@ -108,9 +118,12 @@ extern "C"
       ret.data_.idx = (size_t) -1;
       return ret;
     }
-    assert(map->arr[idx] == WG14_SIGNALS_NULLPTR);
-    map->arr[idx] = val;
-    ret.data_.val = map->arr[idx];
+    assert(atomic_load_explicit(&map->arr[idx],
+                                WG14_SIGNALS_ATOMIC_PREFIX
+                                memory_order_relaxed) == 0);
+    atomic_store_explicit(&map->arr[idx], (uintptr_t) val,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    ret.data_.val = val;
     ret.data_.idx = idx;
     return ret;
   }
@@ -119,7 +132,8 @@ extern "C"
   WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr) it)
   {
     assert(it.data_.idx < NSIG);
-    map->arr[it.data_.idx] = WG14_SIGNALS_NULLPTR;
+    atomic_store_explicit(&map->arr[it.data_.idx], 0,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
   }
 #else
 #define NAME WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t)
@@ -139,91 +153,385 @@ extern "C"
 
   /**********************************************************************************/
 
+  /* The global decider registry is read lock-free, RCU style. Every raise that
+  falls through the thread-local frames walks an immutable, versioned snapshot
+  of its signal's deciders; signal_decider_create()/destroy() and the
+  install/uninstall paths (which serialise per signal, on the lock of that
+  signal's container) publish a new snapshot and *retire* whatever a concurrent
+  raise may still be walking.
+  Retired objects go onto a limbo list and are freed once every raise that
+  could have observed them has left its read-side critical section.
+
+  A raise announces itself by storing the global epoch (plus one, as zero means
+  "not reading") into its thread's own reader record, which sits on its own
+  cache lines: the raise path therefore takes no lock and writes no shared
+  cache line. A retired object is tagged with the epoch it was retired in, and
+  is freed once no announced reader is at or below that tag.
+  */
+  struct WG14_SIGNALS_PREFIX(sig_retired_t)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) * next;
+    uintptr_t epoch;
+    // What to pass to sig_free(): the object itself, or for an over-aligned
+    // heap object the start of its allocation.
+    void *allocation;
+  };
+
+  // The registration of one decider for one signal. The nodes of all the
+  // signals a signal_decider_create() guards live in its handle's single
+  // allocation, and are retired together with it.
   struct WG14_SIGNALS_PREFIX(global_signal_decider_t)
   {
-    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * prev, *next;
-    int refcount;
+    // Unique per registration, used to find this decider again in a newer
+    // snapshot after a sigdecider_abandon()/sigdecider_abandon_resume() cycle.
+    // Zero until the node has been published, so zero for a signal without an
+    // installed handler.
+    uintptr_t id;
+    int signo;
+    // Set by signal_decider_destroy(): a raise still walking a snapshot that
+    // contains this node skips it, so a destroyed decider is never invoked
+    // after its destroy returned, even mid-walk on the destroying thread.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint dead;
 
     WG14_SIGNALS_PREFIX(sig_decide_t) * decider;
     union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
   };
 
+  // The opaque handle signal_decider_create() returns: a header followed by
+  // the `count` registration nodes, one per guarded signal in ascending signal
+  // order, in one allocation. A create or destroy therefore costs a single
+  // allocation or retirement however many signals it guards, and walks only
+  // the guarded signals rather than every signal below NSIG.
+  struct WG14_SIGNALS_PREFIX(signal_decider_handle_t)
+  {
+    // Must be first: the limbo list frees the handle, nodes and all, through
+    // this header.
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) retired;
+    size_t count;
+  };
+#define WG14_SIGNALS_DECIDER_HANDLE_HEADER_SIZE                                \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(signal_decider_handle_t)) +              \
+    sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t)) - 1) /         \
+   sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t)) *               \
+   sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t)))
+  static inline struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *
+  WG14_SIGNALS_PREFIX(signal_decider_handle_nodes)(
+  struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) * handle)
+  {
+    return (struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *) ((
+    char *) handle + WG14_SIGNALS_DECIDER_HANDLE_HEADER_SIZE);
+  }
+
+#define WG14_SIGNALS_DECIDER_SNAPSHOT_ALIGNMENT 64
+
+  // One hot (decider, value) pair of a snapshot. `decider` is atomic so that
+  // signal_decider_destroy() can blank a destroyed decider's pair in place in
+  // the published snapshot, which a raise walking it then skips.
+  struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t)
+  {
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t decider;
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  };
+
+  // An immutable, published array of a signal's deciders in invocation order,
+  // rebuilt on every registration change. The allocation is cache line
+  // aligned and laid out as the header, then the `count` (decider, value)
+  // pairs the raise path reads, packed contiguously so that a handful of
+  // deciders share one or two cache lines, then the `count` registration nodes
+  // the pairs were copied from, which only writers and the rare revalidation
+  // paths read.
+  struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t)
+  {
+    // Must be first: the limbo list frees the snapshot through this header.
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) retired;
+    uintptr_t version;
+    size_t count;
+  };
+#define WG14_SIGNALS_DECIDER_SNAPSHOT_HEADER_SIZE                              \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t)) +     \
+    sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t)) - 1) &   \
+   ~(sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t)) - 1))
+  static inline struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *
+  WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(
+  const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) * snap)
+  {
+    return (struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *) ((
+    char *) snap + WG14_SIGNALS_DECIDER_SNAPSHOT_HEADER_SIZE);
+  }
+  static inline struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **
+  WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(
+  const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) * snap)
+  {
+    return (struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **) (
+    WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(snap) +
+    snap->count);
+  }
+
   struct WG14_SIGNALS_PREFIX(sighandler_info)
   {
+    // Must be first: the limbo list frees the container through this header.
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) retired;
+    // Serialises every writer to this one signal -- install, uninstall and
+    // decider create/destroy -- so writers to different signals never
+    // contend. Ordered after state->lock and before state->reclaim_lock.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint lock;
+    // Set under `lock` when the container is erased from the map: a writer
+    // which found the container before then and locked it after must look the
+    // signal up again.
+    bool erased;
     // Number of active siginstall() holders of this handler: the container is
-    // removed from the map when this reaches zero.
+    // removed from the map and retired when this reaches zero.
     int install_count;
-    // Number of references keeping the container alive: the map holds one,
-    // and each in-flight raise takes its own so that a concurrent siguninstall
-    // cannot free the container while the raise is unlocked inside a decider
-    // call (analysis.md 2.2/W4).
-    int lifetime_refcount;
+    int signo;
 #ifndef _WIN32
     struct sigaction old_handler;
 #endif
-    struct
+    // Incremented for each snapshot published, under `lock`.
+    uintptr_t version;
+    // The published global_signal_decider_snapshot_t *, or zero when no
+    // decider is registered for this signal.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t deciders;
+  };
+
+  // A thread's read-side announcement for the lock-free decider dispatch.
+  // Records are registered once in a lock-free list and recycled, never freed,
+  // so a writer scanning the list can never touch freed memory. The record is
+  // padded to two cache lines so two threads' announcements never share one.
+  struct WG14_SIGNALS_PREFIX(sig_reader_t)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) * next;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint in_use;
+    // Zero when the thread is not walking a snapshot, else one plus the
+    // global epoch observed on entry.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t epoch;
+    char padding[128 - 2 * sizeof(void *) - sizeof(uintptr_t)];
+  };
+
+#define WG14_SIGNALS_SIGNAL_MASK_BITS (sizeof(uintptr_t) * 8)
+#define WG14_SIGNALS_SIGNAL_MASK_WORDS                                         \
+  ((NSIG + WG14_SIGNALS_SIGNAL_MASK_BITS - 1) / WG14_SIGNALS_SIGNAL_MASK_BITS)
+
+  // A bit per signal number, readable without any lock.
+  typedef struct WG14_SIGNALS_PREFIX(sig_mask_t)
+  {
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t
+    words[WG14_SIGNALS_SIGNAL_MASK_WORDS];
+  } WG14_SIGNALS_PREFIX(sig_mask_t);
+
+  // ASYNC-SIGNAL-SAFE.
+  static inline bool
+  WG14_SIGNALS_PREFIX(sig_mask_test)(WG14_SIGNALS_PREFIX(sig_mask_t) * mask,
+                                     const int signo)
+  {
+    const uintptr_t bit =
+    (uintptr_t) 1 << ((size_t) signo % WG14_SIGNALS_SIGNAL_MASK_BITS);
+    return (atomic_load_explicit(
+            &mask->words[(size_t) signo / WG14_SIGNALS_SIGNAL_MASK_BITS],
+            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) &
+            bit) != 0;
+  }
+
+  static inline void
+  WG14_SIGNALS_PREFIX(sig_mask_assign)(WG14_SIGNALS_PREFIX(sig_mask_t) * mask,
+                                       const int signo, const bool set)
+  {
+    const uintptr_t bit =
+    (uintptr_t) 1 << ((size_t) signo % WG14_SIGNALS_SIGNAL_MASK_BITS);
+    if(set)
     {
-      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * front, *back;
-    } global_handler;
-    struct
+      atomic_fetch_or_explicit(
+      &mask->words[(size_t) signo / WG14_SIGNALS_SIGNAL_MASK_BITS], bit,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    }
+    else
     {
-      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * front, *back;
-    } deferred_frees;
+      atomic_fetch_and_explicit(
+      &mask->words[(size_t) signo / WG14_SIGNALS_SIGNAL_MASK_BITS], ~bit,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    }
+  }
+
+  /* The registration paths' fixed-size objects come from lock-free slab
+  pools rather than from WG14_SIGNALS_CALLOC()/WG14_SIGNALS_FREE(): the
+  containers, the handles of deciders guarding a single signal, and the
+  snapshots of up to WG14_SIGNALS_SNAPSHOT_POOL_DECIDERS deciders. A pool's
+  slab is allocated on first use and never freed; an allocation and a free
+  are then a pop and a push of a free list, so registration churn takes no
+  malloc lock and the limbo list's reclaim is async signal safe for pooled
+  objects. An exhausted pool falls back to the heap, and a capacity of zero
+  disables a pool.
+  */
+#ifndef WG14_SIGNALS_SIGHANDLER_INFO_POOL_CAPACITY
+#define WG14_SIGNALS_SIGHANDLER_INFO_POOL_CAPACITY 64
+#endif
+#ifndef WG14_SIGNALS_DECIDER_POOL_CAPACITY
+#define WG14_SIGNALS_DECIDER_POOL_CAPACITY 256
+#endif
+#ifndef WG14_SIGNALS_SNAPSHOT_POOL_CAPACITY
+#define WG14_SIGNALS_SNAPSHOT_POOL_CAPACITY 128
+#endif
+#ifndef WG14_SIGNALS_SNAPSHOT_POOL_DECIDERS
+#define WG14_SIGNALS_SNAPSHOT_POOL_DECIDERS 4
+#endif
+
+  // Slots are whole cache lines, so pooled objects never share one, and are
+  // aligned at least as strictly as a decider snapshot must be.
+#define WG14_SIGNALS_POOL_ALIGNMENT 64
+#define WG14_SIGNALS_POOL_STRIDE(size)                                         \
+  (((size) + WG14_SIGNALS_POOL_ALIGNMENT - 1) &                                \
+   ~(size_t) (WG14_SIGNALS_POOL_ALIGNMENT - 1))
+
+  struct WG14_SIGNALS_PREFIX(sig_pool_t)
+  {
+    // `capacity` slots of `stride` bytes, followed by one free list link per
+    // slot holding one plus the index of the next free slot (zero ends the
+    // list).
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t slab;
+    // The low 32 bits are one plus the index of the first free slot, the high
+    // 32 bits count updates of the head, so that a pop which read a slot's
+    // link before another thread popped and pushed back that slot fails its
+    // compare exchange rather than installing a stale link (ABA).
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong head;
   };
 
-  // Drop one reference on a sighandler_info container; when the last reference
-  // goes away, retire any deciders already moved to deferred_frees, detach any
-  // decider still registered for the signal, and free the container. The
-  // caller must hold state->lock.
-  static void WG14_SIGNALS_PREFIX(sighandler_info_release)(
-  struct WG14_SIGNALS_PREFIX(sighandler_info) * item)
+  static inline WG14_SIGNALS_ATOMIC_PREFIX atomic_uint *
+  WG14_SIGNALS_PREFIX(sig_pool_links)(const uintptr_t slab, const size_t stride,
+                                      const size_t capacity)
+  {
+    return (WG14_SIGNALS_ATOMIC_PREFIX atomic_uint *) (slab +
+                                                       capacity * stride);
+  }
+
+  // Returns the pool's slab, allocating it if this is the pool's first use.
+  // Returns zero if the slab could not be allocated.
+  static uintptr_t WG14_SIGNALS_PREFIX(sig_pool_slab)(
+  struct WG14_SIGNALS_PREFIX(sig_pool_t) * pool, const size_t stride,
+  const size_t capacity)
+  {
+    uintptr_t slab = atomic_load_explicit(
+    &pool->slab, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    if(slab != 0)
+    {
+      return slab;
+    }
+    // WG14_SIGNALS_MALLOC() has no alignment parameter, so over-allocate and
+    // align by hand.
+    void *mem = WG14_SIGNALS_MALLOC(
+    WG14_SIGNALS_POOL_ALIGNMENT - 1 + capacity * stride +
+    capacity * sizeof(WG14_SIGNALS_ATOMIC_PREFIX atomic_uint));
+    if(mem == WG14_SIGNALS_NULLPTR)
+    {
+      return 0;
+    }
+    slab = ((uintptr_t) mem + WG14_SIGNALS_POOL_ALIGNMENT - 1) &
+           ~(uintptr_t) (WG14_SIGNALS_POOL_ALIGNMENT - 1);
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint *links =
+    WG14_SIGNALS_PREFIX(sig_pool_links)(slab, stride, capacity);
+    for(size_t n = 0; n < capacity; n++)
+    {
+      atomic_store_explicit(&links[n],
+                            (n + 1 < capacity) ? (unsigned) (n + 2) : 0u,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    uintptr_t expected = 0;
+    if(!atomic_compare_exchange_strong_explicit(
+       &pool->slab, &expected, slab,
+       WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,
+       WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire))
+    {
+      // Another thread installed its slab first.
+      WG14_SIGNALS_FREE(mem);
+      return expected;
+    }
+    // Until this store the free list reads as empty and allocations fall back
+    // to the heap. Nothing can be pushed before it, as nothing was popped.
+    atomic_store_explicit(&pool->head, 1ull,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    return slab;
+  }
+
+  // ASYNC-SIGNAL-SAFE once the slab exists. Returns a zeroed slot, or NULL if
+  // the pool is disabled or exhausted.
+  static void *WG14_SIGNALS_PREFIX(sig_pool_alloc)(
+  struct WG14_SIGNALS_PREFIX(sig_pool_t) * pool, const size_t stride,
+  const size_t capacity)
   {
-    if(0 == --item->lifetime_refcount)
+    if(capacity == 0)
     {
-      while(item->deferred_frees.front != WG14_SIGNALS_NULLPTR)
+      return WG14_SIGNALS_NULLPTR;
+    }
+    const uintptr_t slab =
+    WG14_SIGNALS_PREFIX(sig_pool_slab)(pool, stride, capacity);
+    if(slab == 0)
+    {
+      return WG14_SIGNALS_NULLPTR;
+    }
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint *links =
+    WG14_SIGNALS_PREFIX(sig_pool_links)(slab, stride, capacity);
+    unsigned long long head = atomic_load_explicit(
+    &pool->head, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    for(;;)
+    {
+      const unsigned idx = (unsigned) (head & 0xffffffffull);
+      if(idx == 0)
       {
-        struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i =
-        item->deferred_frees.front;
-        LIST_REMOVE(item->deferred_frees, i);
-        WG14_SIGNALS_FREE(i);
+        return WG14_SIGNALS_NULLPTR;
       }
-      // Any decider node still registered for this signal (its
-      // signal_decider_destroy() handle not yet called) is detached rather than
-      // left with prev/next pointing into the freed container: the node stays
-      // owned by the handle and is freed when that handle is destroyed
-      // (analysis.md 2.23/AA1).
-      while(item->global_handler.front != WG14_SIGNALS_NULLPTR)
+      const unsigned next = atomic_load_explicit(
+      &links[idx - 1], WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      const unsigned long long newhead =
+      (((head >> 32) + 1) << 32) | (unsigned long long) next;
+      if(atomic_compare_exchange_weak_explicit(
+         &pool->head, &head, newhead,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire))
       {
-        struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i =
-        item->global_handler.front;
-        LIST_REMOVE(item->global_handler, i);
+        void *ret = (void *) (slab + (size_t) (idx - 1) * stride);
+        WG14_SIGNALS_MEMSET(ret, 0, stride);
+        return ret;
       }
-      WG14_SIGNALS_FREE(item);
     }
   }
 
-  // Returns true if node is currently linked in item->global_handler. The
-  // caller must hold state->lock. A node orphaned by a siguninstall that freed
-  // its original container is detached, so it is not found here.
-  static bool WG14_SIGNALS_PREFIX(sighandler_info_has_decider)(
-  struct WG14_SIGNALS_PREFIX(sighandler_info) * item,
-  struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * node)
+  // ASYNC-SIGNAL-SAFE. Returns false if `p` did not come from the pool.
+  static bool WG14_SIGNALS_PREFIX(sig_pool_free)(
+  struct WG14_SIGNALS_PREFIX(sig_pool_t) * pool, const size_t stride,
+  const size_t capacity, void *p)
   {
-    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *current =
-    item->global_handler.front;
-    while(current != WG14_SIGNALS_NULLPTR)
+    const uintptr_t slab = atomic_load_explicit(
+    &pool->slab, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    if(slab == 0 || (uintptr_t) p < slab ||
+       (uintptr_t) p >= slab + capacity * stride)
+    {
+      return false;
+    }
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint *links =
+    WG14_SIGNALS_PREFIX(sig_pool_links)(slab, stride, capacity);
+    const unsigned idx = 1 + (unsigned) (((uintptr_t) p - slab) / stride);
+    unsigned long long head = atomic_load_explicit(
+    &pool->head, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    for(;;)
     {
-      if(current == node)
+      atomic_store_explicit(&links[idx - 1],
+                            (unsigned) (head & 0xffffffffull),
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      const unsigned long long newhead =
+      (((head >> 32) + 1) << 32) | (unsigned long long) idx;
+      if(atomic_compare_exchange_weak_explicit(
+         &pool->head, &head, newhead,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_release,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
       {
         return true;
       }
-      current = current->next;
     }
-    return false;
   }
 
   struct WG14_SIGNALS_PREFIX(sig_global_state_t)
   {
+    // Guards the signo to container map's structure, sighandlers_count and
+    // the per-thread state's lifetime. Only installing and uninstalling take
+    // it; per-signal state is guarded by each container's own lock.
     WG14_SIGNALS_ATOMIC_PREFIX atomic_uint lock;
     int sighandlers_count;
 #ifdef _WIN32
@@ -231,6 +539,56 @@ extern "C"
     LPTOP_LEVEL_EXCEPTION_FILTER old_unhandled_exception_filter;
 #endif
     WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t) signo_to_sighandler_map;
+    // Summaries of the map the raise path tests before doing anything else:
+    // the signals with a container in the map (set and cleared alongside the
+    // map, under `lock`), and the signals whose container has at least one
+    // global decider (under the container's lock). Many installed signals,
+    // say SIGPIPE or SIGCHLD, never get a decider, and a raise of one needs
+    // no snapshot walk.
+    WG14_SIGNALS_PREFIX(sig_mask_t) installed_signals;
+    WG14_SIGNALS_PREFIX(sig_mask_t) decider_signals;
+    // The lock-free dispatch's reclamation state. `epoch` is advanced by every
+    // retire; `readers` heads the registry of per-thread reader records;
+    // `anonymous_readers` counts raises without a reader record (a Windows
+    // exception on a thread that never set up its per-thread state), which
+    // block all reclamation while in flight. `retired` is the limbo list,
+    // guarded by `reclaim_lock` which is only ever held briefly and innermost,
+    // so that writers to different signals can retire concurrently.
+    // `next_decider_id` is the registration counter.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t epoch;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t readers;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint anonymous_readers;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint reclaim_lock;
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) * retired;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t next_decider_id;
+    // The limbo list's counters, written under `reclaim_lock` and read
+    // without it by sigreclaim_stats(): the objects on the list now, the most
+    // there have ever been, and the totals retired and reclaimed. Then the
+    // waits which gave up with the list still over its bound, written
+    // without the lock.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t reclaim_pending;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t reclaim_pending_peak;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t reclaim_retired;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t reclaim_reclaimed;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t reclaim_waits_abandoned;
+    // The slab pools of containers, single signal decider handles and small
+    // decider snapshots.
+    struct WG14_SIGNALS_PREFIX(sig_pool_t) sighandler_info_pool;
+    struct WG14_SIGNALS_PREFIX(sig_pool_t) decider_pool;
+    struct WG14_SIGNALS_PREFIX(sig_pool_t) snapshot_pool;
+#ifndef _WIN32
+    // The published sig_region_table_t * of every guarded region registered
+    // with sigguarded_regions_register(), or zero when there are none. The
+    // registrations it is built from are listed under `regions_lock`, which
+    // is ordered before `reclaim_lock`.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t regions;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint regions_lock;
+    struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *
+    region_registrations;
+    // Deregistered registrations the published table may still refer to,
+    // retired by the next successful republish, under `regions_lock`.
+    struct WG14_SIGNALS_PREFIX(sig_region_registration_t) * region_orphans;
+#endif
   };
   WG14_SIGNALS_EXTERN struct WG14_SIGNALS_PREFIX(sig_global_state_t) *
   WG14_SIGNALS_PREFIX(sig_global_state)(void)
@@ -285,19 +643,652 @@ extern "C"
     const sigset_t *guarded;
     WG14_SIGNALS_PREFIX(sig_recover_t) * recovery;
     WG14_SIGNALS_PREFIX(sig_decide_t) * decider;
-    struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi;
+    // The value passed to sigguarded(). The siginfo a recovery is called with
+    // is handed over in the thread's state, as only a recovery needs it.
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    // `guarded` as a frame mask, and the thread's union of the masks of the
+    // frames below this one, restored when this frame is popped.
+    uint64_t guarded_mask;
+    uint64_t outer_mask;
 #endif
+#if WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT && !defined(_WIN32)
+    // The frame pointer, stack pointer and resume address: the compiler spills
+    // everything else live across __builtin_setjmp() itself.
+    void *buf[5];
+#else
     jmp_buf buf;
+#endif
   };
   struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t)
   {
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_per_frame_t) * front;
+    // This thread's read-side record for the lock-free global decider
+    // dispatch, taken from the registry when the per-thread state is created
+    // and handed back when it is destroyed.
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) * reader;
+#ifndef _WIN32
+    // The union of the guarded masks of every frame in `front`, so a raise of
+    // a signal no frame guards need not walk them. Always a superset while a
+    // frame is pushed or popped: it gains bits before `front` does and loses
+    // them after.
+    uint64_t guarded_mask;
+    // The siginfo of the recovery a frame is being longjmp'd to for.
+    struct WG14_SIGNALS_PREFIX(stdc_siginfo) recovery_rsi;
+#endif
 #ifdef _WIN32
     // Used to detect when stdc_raise() initiated an exception raise
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_win_t) *
     stdc_raise_initiated_exception;
 #endif
   };
+  // Take a reader record for the calling thread: recycle one released by an
+  // exited thread, else allocate and push a new one. Lock-free; not
+  // async-signal-safe (it may allocate), so it runs when the per-thread state
+  // is created, never inside a raise.
+  static struct WG14_SIGNALS_PREFIX(sig_reader_t) *
+  WG14_SIGNALS_PREFIX(sig_reader_acquire)(void)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    for(struct WG14_SIGNALS_PREFIX(sig_reader_t) *r =
+        (struct WG14_SIGNALS_PREFIX(sig_reader_t) *) atomic_load_explicit(
+        &state->readers, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        r != WG14_SIGNALS_NULLPTR; r = r->next)
+    {
+      // A released record still announcing an epoch belongs to a raise whose
+      // per-thread state was destroyed under it (a fallback TLS teardown by
+      // the final siguninstall); it becomes reusable once that raise leaves.
+      unsigned expected = 0;
+      if(atomic_load_explicit(
+         &r->in_use, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) == 0 &&
+         atomic_load_explicit(
+         &r->epoch, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) == 0 &&
+         atomic_compare_exchange_strong_explicit(
+         &r->in_use, &expected, 1,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        return r;
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) *r =
+    (struct WG14_SIGNALS_PREFIX(sig_reader_t) *) WG14_SIGNALS_CALLOC(
+    1, sizeof(struct WG14_SIGNALS_PREFIX(sig_reader_t)));
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      errno = ENOMEM;
+      return WG14_SIGNALS_NULLPTR;
+    }
+    atomic_store_explicit(&r->in_use, 1,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    uintptr_t head = atomic_load_explicit(
+    &state->readers, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    do
+    {
+      r->next = (struct WG14_SIGNALS_PREFIX(sig_reader_t) *) head;
+    } while(!atomic_compare_exchange_weak_explicit(
+    &state->readers, &head, (uintptr_t) r,
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_release,
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed));
+    return r;
+  }
+
+  // Hand a reader record back to the registry for reuse by a later thread.
+  // Records are never freed, so a raise may keep using the one it entered
+  // with even if its per-thread state is destroyed meanwhile.
+  static void WG14_SIGNALS_PREFIX(sig_reader_release)(
+  struct WG14_SIGNALS_PREFIX(sig_reader_t) * r)
+  {
+    if(r != WG14_SIGNALS_NULLPTR)
+    {
+      atomic_store_explicit(&r->in_use, 0,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    }
+  }
+
+  // Enter the read side of the decider dispatch using reader record r, or the
+  // anonymous reader count if the thread has none. Returns true if this call
+  // made the announcement (and so must leave it with sig_reader_exit()), false
+  // if an outer raise on this thread -- one this raise interrupted as a nested
+  // signal -- already announced an older epoch, which protects everything this
+  // raise can observe too. A nested raise interrupting the load/store window
+  // below announces and withdraws its own epoch before the outer store lands,
+  // so the outer raise's announcement is never lost. The seq_cst store and
+  // fence pair with the fence in sig_reclaim(): either the writer sees this
+  // announcement, or this raise sees everything published before the retire.
+  // ASYNC-SIGNAL-SAFE.
+  static bool WG14_SIGNALS_PREFIX(sig_reader_enter)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sig_reader_t) * r)
+  {
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      atomic_fetch_add_explicit(
+      &state->anonymous_readers, 1,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      return true;
+    }
+    if(atomic_load_explicit(
+       &r->epoch, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) != 0)
+    {
+      return false;
+    }
+    atomic_store_explicit(
+    &r->epoch,
+    1 + atomic_load_explicit(&state->epoch,
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst),
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    atomic_thread_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    return true;
+  }
+
+  // Leave the read side entered by sig_reader_enter(). ASYNC-SIGNAL-SAFE.
+  static void WG14_SIGNALS_PREFIX(sig_reader_exit)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sig_reader_t) * r, const bool announced)
+  {
+    if(!announced)
+    {
+      return;
+    }
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      atomic_fetch_sub_explicit(
+      &state->anonymous_readers, 1,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+      return;
+    }
+    atomic_store_explicit(&r->epoch, 0,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+  }
+
+#define WG14_SIGNALS_SIGHANDLER_INFO_POOL_STRIDE                               \
+  WG14_SIGNALS_POOL_STRIDE(sizeof(struct WG14_SIGNALS_PREFIX(sighandler_info)))
+#define WG14_SIGNALS_DECIDER_POOL_STRIDE                                       \
+  WG14_SIGNALS_POOL_STRIDE(                                                    \
+  WG14_SIGNALS_DECIDER_HANDLE_HEADER_SIZE +                                    \
+  sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t)))
+#define WG14_SIGNALS_SNAPSHOT_POOL_STRIDE                                      \
+  WG14_SIGNALS_POOL_STRIDE(                                                    \
+  WG14_SIGNALS_DECIDER_SNAPSHOT_HEADER_SIZE +                                  \
+  WG14_SIGNALS_SNAPSHOT_POOL_DECIDERS *                                        \
+  (sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t)) +         \
+   sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *)))
+
+  // Free an object from any of the pools, or from the heap. ASYNC-SIGNAL-SAFE
+  // for a pooled object.
+  static void WG14_SIGNALS_PREFIX(sig_free)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state, void *p)
+  {
+    if(WG14_SIGNALS_PREFIX(sig_pool_free)(
+       &state->sighandler_info_pool, WG14_SIGNALS_SIGHANDLER_INFO_POOL_STRIDE,
+       WG14_SIGNALS_SIGHANDLER_INFO_POOL_CAPACITY, p) ||
+       WG14_SIGNALS_PREFIX(sig_pool_free)(&state->decider_pool,
+                                          WG14_SIGNALS_DECIDER_POOL_STRIDE,
+                                          WG14_SIGNALS_DECIDER_POOL_CAPACITY,
+                                          p) ||
+       WG14_SIGNALS_PREFIX(sig_pool_free)(&state->snapshot_pool,
+                                          WG14_SIGNALS_SNAPSHOT_POOL_STRIDE,
+                                          WG14_SIGNALS_SNAPSHOT_POOL_CAPACITY,
+                                          p))
+    {
+      return;
+    }
+    WG14_SIGNALS_FREE(p);
+  }
+
+  // Put an object no longer reachable from any published structure onto the
+  // limbo list.
+  static void WG14_SIGNALS_PREFIX(sig_retire)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sig_retired_t) * obj)
+  {
+    obj->epoch = 1 + atomic_fetch_add_explicit(
+                     &state->epoch, 1,
+                     WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    LOCK(state->reclaim_lock);
+    obj->next = state->retired;
+    state->retired = obj;
+    const uintptr_t pending =
+    1 + atomic_load_explicit(&state->reclaim_pending,
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    atomic_store_explicit(&state->reclaim_pending, pending,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(pending > atomic_load_explicit(
+                 &state->reclaim_pending_peak,
+                 WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+    {
+      atomic_store_explicit(&state->reclaim_pending_peak, pending,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    atomic_store_explicit(
+    &state->reclaim_retired,
+    1 + atomic_load_explicit(&state->reclaim_retired,
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed),
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    UNLOCK(state->reclaim_lock);
+  }
+
+  // The epoch of the oldest announced reader, before which every retired
+  // object may be freed: UINTPTR_MAX for none, and zero, freeing nothing, while
+  // a reader without a record may be walking anything.
+  static uintptr_t WG14_SIGNALS_PREFIX(sig_oldest_reader)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state)
+  {
+    atomic_thread_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    if(atomic_load_explicit(&state->anonymous_readers,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst) !=
+       0)
+    {
+      return 0;
+    }
+    uintptr_t oldest = UINTPTR_MAX;
+    for(struct WG14_SIGNALS_PREFIX(sig_reader_t) *r =
+        (struct WG14_SIGNALS_PREFIX(sig_reader_t) *) atomic_load_explicit(
+        &state->readers, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        r != WG14_SIGNALS_NULLPTR; r = r->next)
+    {
+      const uintptr_t e = atomic_load_explicit(
+      &r->epoch, WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      if(e != 0 && e < oldest)
+      {
+        oldest = e;
+      }
+    }
+    return oldest;
+  }
+
+  // Free every limbo object retired before `oldest`, as found by
+  // sig_oldest_reader(). The freeable objects are unlinked under
+  // state->reclaim_lock and freed after releasing it.
+  static void WG14_SIGNALS_PREFIX(sig_reclaim_before)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  const uintptr_t oldest)
+  {
+    if(oldest == 0)
+    {
+      return;
+    }
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) *freeable = WG14_SIGNALS_NULLPTR;
+    uintptr_t freed = 0;
+    LOCK(state->reclaim_lock);
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) **pp = &state->retired;
+    while(*pp != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(sig_retired_t) *obj = *pp;
+      if(obj->epoch < oldest)
+      {
+        *pp = obj->next;
+        obj->next = freeable;
+        freeable = obj;
+        freed++;
+      }
+      else
+      {
+        pp = &obj->next;
+      }
+    }
+    if(freed != 0)
+    {
+      atomic_store_explicit(
+      &state->reclaim_pending,
+      atomic_load_explicit(&state->reclaim_pending,
+                           WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) -
+      freed,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      atomic_store_explicit(
+      &state->reclaim_reclaimed,
+      atomic_load_explicit(&state->reclaim_reclaimed,
+                           WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) +
+      freed,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    UNLOCK(state->reclaim_lock);
+    while(freeable != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(sig_retired_t) *obj = freeable;
+      freeable = obj->next;
+      WG14_SIGNALS_PREFIX(sig_free)(state, obj->allocation);
+    }
+  }
+
+  // Free every limbo object which no announced reader can still be walking:
+  // those retired before the oldest announcement was made.
+  static void WG14_SIGNALS_PREFIX(sig_reclaim)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state)
+  {
+    WG14_SIGNALS_PREFIX(sig_reclaim_before)(
+    state, WG14_SIGNALS_PREFIX(sig_oldest_reader)(state));
+  }
+
+  // Publish a new decider snapshot for `item`: the current one minus any
+  // blanked (destroyed) deciders, plus `add` (if not NULL) at the front or
+  // back. The previous snapshot is retired. Returns false on allocation
+  // failure, leaving the published snapshot as it was. The caller holds
+  // item->lock.
+  //
+  // A blanked pair's registration node is retired by signal_decider_destroy()
+  // itself and may already be gone, so it is recognised by its blanked
+  // decider alone and its node is never dereferenced.
+  static bool WG14_SIGNALS_PREFIX(sighandler_info_republish)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item,
+  struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * add, const bool front)
+  {
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *old =
+    (struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+    atomic_load_explicit(&item->deciders,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **oldnodes =
+    (old != WG14_SIGNALS_NULLPTR)
+    ? WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(old)
+    : WG14_SIGNALS_NULLPTR;
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *oldentries =
+    (old != WG14_SIGNALS_NULLPTR)
+    ? WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(old)
+    : WG14_SIGNALS_NULLPTR;
+    const size_t oldcount = (old != WG14_SIGNALS_NULLPTR) ? old->count : 0;
+    size_t count = (add != WG14_SIGNALS_NULLPTR) ? 1 : 0;
+    for(size_t n = 0; n < oldcount; n++)
+    {
+      if(0 != atomic_load_explicit(
+              &oldentries[n].decider,
+              WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        count++;
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *snap =
+    WG14_SIGNALS_NULLPTR;
+    if(count > 0)
+    {
+      // Pool slots are already suitably aligned.
+      void *mem = (count <= WG14_SIGNALS_SNAPSHOT_POOL_DECIDERS)
+                  ? WG14_SIGNALS_PREFIX(sig_pool_alloc)(
+                    &state->snapshot_pool, WG14_SIGNALS_SNAPSHOT_POOL_STRIDE,
+                    WG14_SIGNALS_SNAPSHOT_POOL_CAPACITY)
+                  : WG14_SIGNALS_NULLPTR;
+      if(mem != WG14_SIGNALS_NULLPTR)
+      {
+        snap =
+        (struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *) mem;
+      }
+      else
+      {
+        // WG14_SIGNALS_CALLOC() has no alignment parameter, so over-allocate
+        // and align by hand, remembering the allocation for the limbo list to
+        // free.
+        mem = WG14_SIGNALS_CALLOC(
+        1, WG14_SIGNALS_DECIDER_SNAPSHOT_ALIGNMENT - 1 +
+           WG14_SIGNALS_DECIDER_SNAPSHOT_HEADER_SIZE +
+           count *
+           (sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t)) +
+            sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *)));
+        if(mem == WG14_SIGNALS_NULLPTR)
+        {
+          return false;
+        }
+        snap =
+        (struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *) (
+        ((uintptr_t) mem + WG14_SIGNALS_DECIDER_SNAPSHOT_ALIGNMENT - 1) &
+        ~(uintptr_t) (WG14_SIGNALS_DECIDER_SNAPSHOT_ALIGNMENT - 1));
+      }
+      snap->retired.allocation = mem;
+      snap->count = count;
+      snap->version = ++item->version;
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **nodes =
+      WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(snap);
+      size_t idx = 0;
+      if(add != WG14_SIGNALS_NULLPTR && front)
+      {
+        nodes[idx++] = add;
+      }
+      for(size_t n = 0; n < oldcount; n++)
+      {
+        if(0 != atomic_load_explicit(
+                &oldentries[n].decider,
+                WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+        {
+          nodes[idx++] = oldnodes[n];
+        }
+      }
+      if(add != WG14_SIGNALS_NULLPTR && !front)
+      {
+        nodes[idx++] = add;
+      }
+      assert(idx == count);
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *entries =
+      WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(snap);
+      for(idx = 0; idx < count; idx++)
+      {
+        atomic_store_explicit(&entries[idx].decider,
+                              (uintptr_t) nodes[idx]->decider,
+                              WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+        entries[idx].value = nodes[idx]->value;
+      }
+    }
+    atomic_store_explicit(&item->deciders, (uintptr_t) snap,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    if((snap != WG14_SIGNALS_NULLPTR) != (old != WG14_SIGNALS_NULLPTR))
+    {
+      WG14_SIGNALS_PREFIX(sig_mask_assign)(&state->decider_signals, item->signo,
+                                           snap != WG14_SIGNALS_NULLPTR);
+    }
+    if(old != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_PREFIX(sig_retire)(state, &old->retired);
+    }
+    return true;
+  }
+
+  // Returns true if node is a live (not blanked) member of item's published
+  // snapshot. The caller holds item->lock. A node orphaned by a siguninstall
+  // that retired its original container is not in the replacement container,
+  // so it is not found here (analysis.md 2.23/AA1). Blanked pairs are skipped
+  // as their node may have been reclaimed and its address reused.
+  static bool WG14_SIGNALS_PREFIX(sighandler_info_has_decider)(
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item,
+  struct WG14_SIGNALS_PREFIX(global_signal_decider_t) * node)
+  {
+    const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *snap =
+    (const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+    atomic_load_explicit(&item->deciders,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(snap == WG14_SIGNALS_NULLPTR)
+    {
+      return false;
+    }
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **nodes =
+    WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(snap);
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *entries =
+    WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(snap);
+    for(size_t n = 0; n < snap->count; n++)
+    {
+      if(nodes[n] == node &&
+         0 != atomic_load_explicit(
+              &entries[n].decider,
+              WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Retire a container already erased from the map, together with its
+  // snapshot. The deciders stay owned by their signal_decider_create()
+  // handles, and are retired when those are destroyed (analysis.md
+  // 2.23/AA1). The snapshot is unpublished first, so a raise still walking it
+  // treats it as stale and checks each decider's dead flag. The caller holds
+  // item->lock.
+  static void WG14_SIGNALS_PREFIX(sighandler_info_retire)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item)
+  {
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *snap =
+    (struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+    atomic_exchange_explicit(&item->deciders, 0,
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(snap != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_PREFIX(sig_mask_assign)(&state->decider_signals, item->signo,
+                                           false);
+      WG14_SIGNALS_PREFIX(sig_retire)(state, &snap->retired);
+    }
+    WG14_SIGNALS_PREFIX(sig_retire)(state, &item->retired);
+  }
+
+  // Look up the container for signo from inside a read-side critical section.
+  // The fixed-array map is read lock-free; the verstable variant (NSIG >= 1024
+  // only) cannot be read concurrently with a writer, so its lookup alone still
+  // takes state->lock.
+  static struct WG14_SIGNALS_PREFIX(sighandler_info) *
+  WG14_SIGNALS_PREFIX(sighandler_info_lookup)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state, const int signo)
+  {
+#if NSIG >= 1024
+    LOCK(state->lock);
+#endif
+    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
+    it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
+    &state->signo_to_sighandler_map, signo);
+    struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it)
+    ? WG14_SIGNALS_NULLPTR
+    : signo_to_sighandler_map_t_value(it);
+#if NSIG >= 1024
+    UNLOCK(state->lock);
+#endif
+    return item;
+  }
+
+  // Look up the container for signo and take its lock, returning NULL if the
+  // signal has no handler installed. The lookup runs as an anonymous reader,
+  // so a container being uninstalled concurrently cannot be freed before its
+  // lock is taken; one found erased once locked is looked up again. Not
+  // async-signal-safe, and must not be called with state->lock held.
+  static struct WG14_SIGNALS_PREFIX(sighandler_info) *
+  WG14_SIGNALS_PREFIX(sighandler_info_lock)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state, const int signo)
+  {
+    const bool announced =
+    WG14_SIGNALS_PREFIX(sig_reader_enter)(state, WG14_SIGNALS_NULLPTR);
+    struct WG14_SIGNALS_PREFIX(sighandler_info) *item;
+    for(;;)
+    {
+      item = WG14_SIGNALS_PREFIX(sighandler_info_lookup)(state, signo);
+      if(item == WG14_SIGNALS_NULLPTR)
+      {
+        break;
+      }
+      LOCK(item->lock);
+      if(!item->erased)
+      {
+        break;
+      }
+      UNLOCK(item->lock);
+    }
+    // A locked container which is not erased cannot be retired, so it stays
+    // valid after leaving the read side.
+    WG14_SIGNALS_PREFIX(sig_reader_exit)(state, WG14_SIGNALS_NULLPTR,
+                                         announced);
+    return item;
+  }
+
+  // Walk item's published decider snapshot, invoking each live decider with
+  // rsi until one claims the signal. Must be called inside a read-side
+  // critical section; returns true if a decider claimed the signal.
+  //
+  // The walk reads only the snapshot's packed (decider, value) pairs while the
+  // snapshot is still the published one, as signal_decider_destroy() blanks a
+  // destroyed decider's pair in the published snapshot. Once a newer snapshot
+  // has been published, a pair may belong to a decider destroyed since, so
+  // the registration node's dead flag is consulted as well.
+  //
+  // rsi->internal_global_reader has bit 0 set while this raise owns the
+  // read-side announcement made through rsi->internal_reader. A decider which
+  // calls sigdecider_abandon() drops that announcement (it may never return),
+  // and sigdecider_abandon_resume() retakes it and sets bit 1. Anything this
+  // walk held may have been freed in between, so after such a cycle the walk
+  // re-resolves the signal's current snapshot and continues after the decider
+  // which just returned, found by its id; if that decider has meanwhile been
+  // destroyed the walk ends there.
+  static bool WG14_SIGNALS_PREFIX(sighandler_info_invoke_deciders)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state,
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item,
+  struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+  {
+    const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *snap =
+    (const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+    atomic_load_explicit(&item->deciders,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    size_t n = 0;
+    while(snap != WG14_SIGNALS_NULLPTR && n < snap->count)
+    {
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *entry =
+      WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(snap) + n++;
+      WG14_SIGNALS_PREFIX(sig_decide_t) *decider =
+      (WG14_SIGNALS_PREFIX(sig_decide_t) *) atomic_load_explicit(
+      &entry->decider, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      if(decider == WG14_SIGNALS_NULLPTR)
+      {
+        continue;
+      }
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *node =
+      WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(snap)[n - 1];
+      if((uintptr_t) snap !=
+         atomic_load_explicit(
+         &item->deciders, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) &&
+         atomic_load_explicit(
+         &node->dead, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        continue;
+      }
+      rsi->value = entry->value;
+      // In case they wish to abandon
+      rsi->internal_sighandler = item;
+      rsi->internal_global_decider = node;
+      if(decider(rsi))
+      {
+        return true;
+      }
+      if((rsi->internal_global_reader & 2) != 0)
+      {
+        // node may have been reclaimed during the abandonment, but its id was
+        // not: read it from the registration in the snapshot we re-resolve.
+        const uintptr_t id = rsi->internal_global_decider_id;
+        rsi->internal_global_reader &= (unsigned char) ~2u;
+        item = WG14_SIGNALS_PREFIX(sighandler_info_lookup)(state, rsi->signo);
+        snap =
+        (item == WG14_SIGNALS_NULLPTR)
+        ? WG14_SIGNALS_NULLPTR
+        : (const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+          atomic_load_explicit(&item->deciders,
+                               WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        const size_t count = (snap != WG14_SIGNALS_NULLPTR) ? snap->count : 0;
+        for(n = 0; n < count; n++)
+        {
+          // A blanked pair's node may already have been reclaimed.
+          if(0 != atomic_load_explicit(
+                  &WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(
+                  snap)[n]
+                   .decider,
+                  WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) &&
+             WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(snap)[n]
+             ->id == id)
+          {
+            break;
+          }
+        }
+        if(n++ >= count)
+        {
+          return false;
+        }
+      }
+    }
+    return false;
+  }
+
 #if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
   WG14_SIGNALS_EXTERN struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *
   *WG14_SIGNALS_PREFIX(sig_tss_state_raw)(void)
@@ -311,6 +1302,13 @@ extern "C"
   {
     return 0;
   }
+  static void WG14_SIGNALS_PREFIX(sig_global_tss_state_free)(void *p)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *mem =
+    (struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *) p;
+    WG14_SIGNALS_PREFIX(sig_reader_release)(mem->reader);
+    free(mem);
+  }
   static int WG14_SIGNALS_PREFIX(sig_global_tss_state_init)(void)
   {
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) **state =
@@ -331,8 +1329,12 @@ extern "C"
       errno = ENOMEM;
       return -1;
     }
+    // A thread without a reader record still raises correctly, via the
+    // anonymous reader count, so a failure here is not fatal.
+    mem->reader = WG14_SIGNALS_PREFIX(sig_reader_acquire)();
     *state = mem;
-    return WG14_SIGNALS_PREFIX(thread_atexit)(free, mem);
+    return WG14_SIGNALS_PREFIX(thread_atexit)(
+    WG14_SIGNALS_PREFIX(sig_global_tss_state_free), mem);
   }
   static struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *
   WG14_SIGNALS_PREFIX(sig_global_tss_state)(void)
@@ -350,15 +1352,50 @@ WG14_SIGNALS_PREFIX(sig_tss_state_raw)(void)
   static WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) v;
   return &v;
 }
+// Advanced whenever the TSS is destroyed, which frees every thread's state.
+static WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t
+WG14_SIGNALS_PREFIX(sig_tss_state_generation);
+// Each thread's cache of its own state, so that a steady state sigguarded() or
+// stdc_raise() neither registers with, nor looks up, the TSS. It is valid while
+// `generation` is one more than sig_tss_state_generation, so a zeroed cache is
+// never valid. Like the TSS's own slot cache, it is only written from outside a
+// signal handler, with signal fences ordering the writes, so a handler
+// interrupting a write sees either an invalid cache or a complete one.
+struct WG14_SIGNALS_PREFIX(sig_tss_state_cache_t)
+{
+  uintptr_t generation;
+  struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) * state;
+};
+static WG14_SIGNALS_THREAD_LOCAL struct WG14_SIGNALS_PREFIX(
+sig_tss_state_cache_t) WG14_SIGNALS_PREFIX(sig_tss_state_cache);
 static int sig_global_state_tss_state_create(void **dest)
 {
   assert(*dest == WG14_SIGNALS_NULLPTR);
-  *dest = WG14_SIGNALS_CALLOC(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *mem =
+  (struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *)
+  WG14_SIGNALS_CALLOC(
   1, sizeof(struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t)));
-  return (*dest != WG14_SIGNALS_NULLPTR) ? 0 : -1;
+  if(mem == WG14_SIGNALS_NULLPTR)
+  {
+    return -1;
+  }
+  // A thread without a reader record still raises correctly, via the
+  // anonymous reader count, so a failure here is not fatal.
+  mem->reader = WG14_SIGNALS_PREFIX(sig_reader_acquire)();
+  *dest = mem;
+  return 0;
 }
 static int sig_global_state_tss_state_destroy(void *p)
 {
+  if(WG14_SIGNALS_PREFIX(sig_tss_state_cache).state == p)
+  {
+    // This thread's own state, destroyed at its exit: a later use on the way
+    // out must register again rather than find it in the cache.
+    WG14_SIGNALS_PREFIX(sig_tss_state_cache).generation = 0;
+    atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+  }
+  WG14_SIGNALS_PREFIX(sig_reader_release)(
+  ((struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *) p)->reader);
   WG14_SIGNALS_FREE(p);
   return 0;
 }
@@ -377,14 +1414,27 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_create)(void)
   // Positional, not designated, initialisation: the .ipp is also compiled as
   // C++11 by the header-only C++ test, where designated initialisers are a
   // C++20 extension and would trip -Wc++20-designator under -Werror. The
-  // struct has exactly the two members create/destroy in this order.
+  // struct has exactly the members create/destroy/max_threads/value_size/
+  // value_alignment/per_cpu in this order.
   const struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) tss_attr = {
-  sig_global_state_tss_state_create, sig_global_state_tss_state_destroy};
+  sig_global_state_tss_state_create, sig_global_state_tss_state_destroy, 0, 0,
+  0, false};
   return WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(
   WG14_SIGNALS_PREFIX(sig_tss_state_raw)(), &tss_attr);
 }
 static int WG14_SIGNALS_PREFIX(sig_global_tss_state_init)(void)
 {
+  struct WG14_SIGNALS_PREFIX(sig_tss_state_cache_t) *cache =
+  &WG14_SIGNALS_PREFIX(sig_tss_state_cache);
+  // Read before the state is looked up, so that a destruction meanwhile leaves
+  // what is cached below invalid.
+  const uintptr_t generation =
+  1 + atomic_load_explicit(&WG14_SIGNALS_PREFIX(sig_tss_state_generation),
+                           WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+  if(cache->generation == generation)
+  {
+    return 0;
+  }
   if(*WG14_SIGNALS_PREFIX(sig_tss_state_raw)() == WG14_SIGNALS_NULLPTR)
   {
     if(-1 == WG14_SIGNALS_PREFIX(sig_global_tss_state_create)())
@@ -392,12 +1442,31 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_init)(void)
       return -1;
     }
   }
-  return WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(
+  const int ret = WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(
   *WG14_SIGNALS_PREFIX(sig_tss_state_raw)());
+  if(ret == 0)
+  {
+    cache->generation = 0;
+    atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    cache->state = (struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *)
+    WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(
+    *WG14_SIGNALS_PREFIX(sig_tss_state_raw)());
+    atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    cache->generation = generation;
+  }
+  return ret;
 }
 static struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *
 WG14_SIGNALS_PREFIX(sig_global_tss_state)(void)
 {
+  const struct WG14_SIGNALS_PREFIX(sig_tss_state_cache_t) *cache =
+  &WG14_SIGNALS_PREFIX(sig_tss_state_cache);
+  if(cache->generation ==
+     1 + atomic_load_explicit(&WG14_SIGNALS_PREFIX(sig_tss_state_generation),
+                              WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire))
+  {
+    return cache->state;
+  }
   return (struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *)
   WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(
   *WG14_SIGNALS_PREFIX(sig_tss_state_raw)());
@@ -408,6 +1477,9 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
   // leaving *sig_tss_state_raw() dangling at the freed tss_async_signal_safe_t;
   // any later sigguarded()/stdc_raise() then thread_init'd the freed handle
   // (analysis.md 2.4/Z3). Reset the slot so the next entry recreates the TSS.
+  // Every thread's cached state is about to be freed.
+  atomic_fetch_add_explicit(&WG14_SIGNALS_PREFIX(sig_tss_state_generation), 1,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
   const int ret = WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)(
   *WG14_SIGNALS_PREFIX(sig_tss_state_raw)());
   *WG14_SIGNALS_PREFIX(sig_tss_state_raw)() = WG14_SIGNALS_NULLPTR;
@@ -416,118 +1488,341 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
 #endif
 
 
-  static bool WG14_SIGNALS_PREFIX(install_sighandler_impl)(
-  struct WG14_SIGNALS_PREFIX(sighandler_info) * item, const int signo);
-  static bool WG14_SIGNALS_PREFIX(uninstall_sighandler_impl)(
-  struct WG14_SIGNALS_PREFIX(sighandler_info) * item, const int signo);
-
-  static bool WG14_SIGNALS_PREFIX(install_sighandler)(const int signo)
+  // The calling thread's reader record, or NULL if it has none. Not async
+  // signal safe.
+  static struct WG14_SIGNALS_PREFIX(sig_reader_t) *
+  WG14_SIGNALS_PREFIX(sig_current_reader)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state)
   {
-    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-    WG14_SIGNALS_PREFIX(sig_global_state)();
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) *r = WG14_SIGNALS_NULLPTR;
+#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
+    (void) state;
+    struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
+    WG14_SIGNALS_PREFIX(sig_global_tss_state)();
+    if(tss != WG14_SIGNALS_NULLPTR)
+    {
+      r = tss->reader;
+    }
+#else
+    // With fallback TLS a concurrent final siguninstall may destroy the
+    // per-thread state, which state->lock excludes. The record itself is never
+    // freed, so it may be used after unlocking.
     LOCK(state->lock);
-    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-    &state->signo_to_sighandler_map, signo);
-    if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+    if(*WG14_SIGNALS_PREFIX(sig_tss_state_raw)() != WG14_SIGNALS_NULLPTR)
     {
-      struct WG14_SIGNALS_PREFIX(sighandler_info) *newitem =
-      (struct WG14_SIGNALS_PREFIX(sighandler_info) *) WG14_SIGNALS_CALLOC(
-      1, sizeof(struct WG14_SIGNALS_PREFIX(sighandler_info)));
-      if(newitem == WG14_SIGNALS_NULLPTR)
+      struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
+      WG14_SIGNALS_PREFIX(sig_global_tss_state)();
+      if(tss != WG14_SIGNALS_NULLPTR)
       {
-        UNLOCK(state->lock);
-        return false;
-      }
-      newitem->lifetime_refcount = 1;
-      if(!WG14_SIGNALS_PREFIX(install_sighandler_impl)(newitem, signo))
-      {
-        // Release the lock before returning failure: a leaked lock would make
-        // every subsequent library call (and any signal delivery through
-        // raw_signal_handler) spin forever (analysis.md 2.20/Y1).
-        int errcode = errno;
-        WG14_SIGNALS_FREE(newitem);
-        errno = errcode;
-        UNLOCK(state->lock);
-        return false;
+        r = tss->reader;
       }
-      it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_insert)(
-      &state->signo_to_sighandler_map, signo, newitem);
     }
-    signo_to_sighandler_map_t_value(it)->install_count++;
-    if(0 == state->sighandlers_count++)
+    UNLOCK(state->lock);
+#endif
+    return r;
+  }
+
+  /* Reclaim, then bound the limbo list. Reclamation alone frees everything a
+  raise can no longer be walking, so what remains was retired while some raise
+  was in progress. Should that exceed WG14_SIGNALS_RECLAIM_PENDING_LIMIT
+  objects, say because a decider runs for a long time while other threads
+  churn registrations, the writer waits for the raises holding it up to leave,
+  reclaiming as they do. The limit is a target rather than a bound: other
+  threads may retire more meanwhile, and the writer may give up.
+
+  It does not wait on a raise of its own thread (signal_decider_destroy()
+  called from a decider), which cannot leave until the writer returns, nor
+  while any raise without a reader record is in flight, as that could be its
+  own too. Nor does it wait for more than WG14_SIGNALS_RECLAIM_WAIT_ROUNDS
+  rounds of backoff, as the raise may be in a decider waiting on the writer's
+  thread to return: it then leaves the garbage pending for a later
+  registration change, and counts the overrun in sigreclaim_stats(). Each
+  round only rescans the reader records, walking the limbo list again only
+  once the oldest of them has moved on, as until then nothing more can be
+  freed. The caller must hold no container lock, as a decider may itself be
+  waiting to take one.
+  */
+#ifndef WG14_SIGNALS_RECLAIM_PENDING_LIMIT
+#define WG14_SIGNALS_RECLAIM_PENDING_LIMIT 1024
+#endif
+#ifndef WG14_SIGNALS_RECLAIM_WAIT_ROUNDS
+#define WG14_SIGNALS_RECLAIM_WAIT_ROUNDS 4096
+#endif
+  static void WG14_SIGNALS_PREFIX(sig_reclaim_bounded)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state)
+  {
+    uintptr_t reclaimed_before = WG14_SIGNALS_PREFIX(sig_oldest_reader)(state);
+    WG14_SIGNALS_PREFIX(sig_reclaim_before)(state, reclaimed_before);
+    if(atomic_load_explicit(&state->reclaim_pending,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) <=
+       WG14_SIGNALS_RECLAIM_PENDING_LIMIT)
     {
-      if(-1 == WG14_SIGNALS_PREFIX(sig_global_tss_state_create)())
+      return;
+    }
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) *own =
+    WG14_SIGNALS_PREFIX(sig_current_reader)(state);
+    for(unsigned backoff = 1, round = 0;; round++)
+    {
+      if(round == WG14_SIGNALS_RECLAIM_WAIT_ROUNDS)
       {
-        // Roll back the install just committed: a handler left installed with
-        // no TSS could never be uninstalled (siginstall has no handle to hand
-        // back), and sighandlers_count must not count a TSS that was never
-        // created (analysis.md 2.3).
-        state->sighandlers_count--;
-        if(0 == --signo_to_sighandler_map_t_value(it)->install_count)
-        {
-          struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
-          signo_to_sighandler_map_t_value(it);
-          (void) WG14_SIGNALS_PREFIX(uninstall_sighandler_impl)(item, signo);
-          WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_erase_itr)
-          (&state->signo_to_sighandler_map, it);
-          WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-        }
-        UNLOCK(state->lock);
-        return false;
+        atomic_fetch_add_explicit(
+        &state->reclaim_waits_abandoned, 1,
+        WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+        return;
+      }
+      if(atomic_load_explicit(&state->anonymous_readers,
+                              WG14_SIGNALS_ATOMIC_PREFIX
+                              memory_order_relaxed) != 0 ||
+         (own != WG14_SIGNALS_NULLPTR &&
+          atomic_load_explicit(&own->epoch, WG14_SIGNALS_ATOMIC_PREFIX
+                                            memory_order_relaxed) != 0))
+      {
+        return;
+      }
+      for(unsigned n = 0; n < backoff; n++)
+      {
+        WG14_SIGNALS_CPU_RELAX();
+      }
+      if(backoff < WG14_SIGNALS_LOCK_MAX_BACKOFF)
+      {
+        backoff <<= 1;
+      }
+      // Announcements only move forwards, and with no readers at all what
+      // other threads retired since the last walk may now be freed.
+      const uintptr_t oldest = WG14_SIGNALS_PREFIX(sig_oldest_reader)(state);
+      if(oldest <= reclaimed_before && oldest != UINTPTR_MAX)
+      {
+        continue;
+      }
+      reclaimed_before = oldest;
+      WG14_SIGNALS_PREFIX(sig_reclaim_before)(state, oldest);
+      if(atomic_load_explicit(
+         &state->reclaim_pending,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) <=
+         WG14_SIGNALS_RECLAIM_PENDING_LIMIT)
+      {
+        return;
       }
     }
-    UNLOCK(state->lock);
-    return true;
   }
 
-  static bool WG14_SIGNALS_PREFIX(uninstall_sighandler)(const int signo)
+  void WG14_SIGNALS_PREFIX(sigreclaim_stats)(
+  struct WG14_SIGNALS_PREFIX(sigreclaim_stats_t) * stats)
   {
     struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
     WG14_SIGNALS_PREFIX(sig_global_state)();
-    LOCK(state->lock);
-    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-    &state->signo_to_sighandler_map, signo);
-    if(!WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+    stats->pending = (size_t) atomic_load_explicit(
+    &state->reclaim_pending, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    stats->pending_peak = (size_t) atomic_load_explicit(
+    &state->reclaim_pending_peak,
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    stats->retired = (size_t) atomic_load_explicit(
+    &state->reclaim_retired, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    stats->reclaimed = (size_t) atomic_load_explicit(
+    &state->reclaim_reclaimed,
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    stats->waits_abandoned = (size_t) atomic_load_explicit(
+    &state->reclaim_waits_abandoned,
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+  }
+
+  static bool WG14_SIGNALS_PREFIX(install_sighandler_impl)(
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item, const int signo);
+  static bool WG14_SIGNALS_PREFIX(uninstall_sighandler_impl)(
+  struct WG14_SIGNALS_PREFIX(sighandler_info) * item, const int signo);
+
+  // The opaque handle siginstall() returns: a header followed by the `count`
+  // signals it installed, in ascending order, so siguninstall() visits just
+  // those rather than testing every signal below NSIG.
+  struct WG14_SIGNALS_PREFIX(siginstall_handle_t)
+  {
+    // Must be first: the handle has always been usable as the sigset_t of the
+    // signals requested (after the internal signals are filtered out).
+    sigset_t guarded;
+    size_t count;
+  };
+#define WG14_SIGNALS_SIGINSTALL_HANDLE_HEADER_SIZE                             \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(siginstall_handle_t)) + sizeof(int) -    \
+    1) &                                                                       \
+   ~(sizeof(int) - 1))
+  static inline int *WG14_SIGNALS_PREFIX(siginstall_handle_signos)(
+  struct WG14_SIGNALS_PREFIX(siginstall_handle_t) * handle)
+  {
+    return (int *) ((char *) handle +
+                    WG14_SIGNALS_SIGINSTALL_HANDLE_HEADER_SIZE);
+  }
+
+  // Drop one installation of each of the first `count` signals of `signos`,
+  // last first, fully uninstalling and retiring the container of any signal
+  // whose install_count reaches zero. The caller holds state->lock.
+  static void WG14_SIGNALS_PREFIX(uninstall_sighandlers_locked)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state, const int *signos,
+  size_t count)
+  {
+    while(count-- > 0)
     {
-      while(signo_to_sighandler_map_t_value(it)->deferred_frees.front !=
-            WG14_SIGNALS_NULLPTR)
+      const int signo = signos[count];
+      WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
+      it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
+      &state->signo_to_sighandler_map, signo);
+      if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
       {
-        struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i =
-        signo_to_sighandler_map_t_value(it)->deferred_frees.front;
-        LIST_REMOVE(signo_to_sighandler_map_t_value(it)->deferred_frees, i);
-        WG14_SIGNALS_FREE(i);
+        continue;
       }
-      const bool need_to_destroy_tss = (0 == --state->sighandlers_count);
-      if(0 == --signo_to_sighandler_map_t_value(it)->install_count)
+      state->sighandlers_count--;
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+      signo_to_sighandler_map_t_value(it);
+      // The container's lock excludes a concurrent decider create or destroy
+      // for this signal, which takes only that lock.
+      LOCK(item->lock);
+      if(0 == --item->install_count)
       {
-        struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
-        signo_to_sighandler_map_t_value(it);
         (void) WG14_SIGNALS_PREFIX(uninstall_sighandler_impl)(item, signo);
         WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_erase_itr)
         (&state->signo_to_sighandler_map, it);
-        // Drop the map's reference on the container; an in-flight raise holds
-        // its own reference and frees the container when it releases
+        WG14_SIGNALS_PREFIX(sig_mask_assign)(&state->installed_signals, signo,
+                                             false);
+        item->erased = true;
+        // Retire rather than free the container: an in-flight raise may still
+        // be walking it, and it is reclaimed once every such raise has left
         // (analysis.md 2.2/W4).
-        WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
+        WG14_SIGNALS_PREFIX(sighandler_info_retire)(state, item);
       }
-      if(need_to_destroy_tss)
+      UNLOCK(item->lock);
+    }
+  }
+
+  // Install the handlers for the `count` signals of `signos` as one batch,
+  // under a single hold of state->lock, all or nothing. The containers of the
+  // signals not yet installed are all allocated before anything changes, so
+  // the only failures left to roll back are a failing sigaction() or TSS
+  // creation. Every signal already processed is then uninstalled again, so a
+  // failed call leaves each signal at its previous install_count.
+  static bool WG14_SIGNALS_PREFIX(install_sighandlers)(const int *signos,
+                                                       const size_t count)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    LOCK(state->lock);
+    // The preallocated containers are chained through their limbo list link,
+    // unused until a container is retired.
+    struct WG14_SIGNALS_PREFIX(sighandler_info) *spare = WG14_SIGNALS_NULLPTR;
+    bool ok = true;
+    for(size_t n = 0; n < count; n++)
+    {
+      if(!WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(
+         WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
+         &state->signo_to_sighandler_map, signos[n])))
       {
-        (void) WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)();
+        continue;
       }
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *newitem =
+      (struct WG14_SIGNALS_PREFIX(sighandler_info) *) WG14_SIGNALS_PREFIX(
+      sig_pool_alloc)(&state->sighandler_info_pool,
+                      WG14_SIGNALS_SIGHANDLER_INFO_POOL_STRIDE,
+                      WG14_SIGNALS_SIGHANDLER_INFO_POOL_CAPACITY);
+      if(newitem == WG14_SIGNALS_NULLPTR)
+      {
+        newitem =
+        (struct WG14_SIGNALS_PREFIX(sighandler_info) *) WG14_SIGNALS_CALLOC(
+        1, sizeof(struct WG14_SIGNALS_PREFIX(sighandler_info)));
+      }
+      if(newitem == WG14_SIGNALS_NULLPTR)
+      {
+        ok = false;
+        break;
+      }
+      newitem->retired.allocation = newitem;
+      newitem->retired.next =
+      (struct WG14_SIGNALS_PREFIX(sig_retired_t) *) spare;
+      spare = newitem;
+    }
+    size_t done = 0;
+    const bool first = (state->sighandlers_count == 0);
+    for(; ok && done < count; done++)
+    {
+      const int signo = signos[done];
+      WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
+      it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
+      &state->signo_to_sighandler_map, signo);
+      if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+      {
+        struct WG14_SIGNALS_PREFIX(sighandler_info) *newitem = spare;
+        spare =
+        (struct WG14_SIGNALS_PREFIX(sighandler_info) *) newitem->retired.next;
+        newitem->retired.next = WG14_SIGNALS_NULLPTR;
+        newitem->signo = signo;
+        if(!WG14_SIGNALS_PREFIX(install_sighandler_impl)(newitem, signo))
+        {
+          int errcode = errno;
+          WG14_SIGNALS_PREFIX(sig_free)(state, newitem);
+          errno = errcode;
+          ok = false;
+          break;
+        }
+        // Not yet published, so nothing else can be holding its lock.
+        newitem->install_count = 1;
+        (void) WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_insert)(
+        &state->signo_to_sighandler_map, signo, newitem);
+        WG14_SIGNALS_PREFIX(sig_mask_assign)(&state->installed_signals, signo,
+                                             true);
+      }
+      else
+      {
+        struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+        signo_to_sighandler_map_t_value(it);
+        LOCK(item->lock);
+        item->install_count++;
+        UNLOCK(item->lock);
+      }
+      state->sighandlers_count++;
+    }
+    // A handler left installed with no TSS could never be uninstalled, and
+    // sighandlers_count must not count a TSS that was never created
+    // (analysis.md 2.3).
+    if(ok && first && state->sighandlers_count != 0 &&
+       -1 == WG14_SIGNALS_PREFIX(sig_global_tss_state_create)())
+    {
+      ok = false;
+    }
+    const int errcode = errno;
+    if(!ok)
+    {
+      WG14_SIGNALS_PREFIX(uninstall_sighandlers_locked)(state, signos, done);
+      WG14_SIGNALS_PREFIX(sig_reclaim)(state);
     }
     UNLOCK(state->lock);
-    return true;
+    while(spare != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *item = spare;
+      spare =
+      (struct WG14_SIGNALS_PREFIX(sighandler_info) *) item->retired.next;
+      WG14_SIGNALS_PREFIX(sig_free)(state, item);
+    }
+    errno = errcode;
+    return ok;
   }
 
-  void *WG14_SIGNALS_PREFIX(siginstall)(const sigset_t *guarded)
+  // Whether siginstall() installs a handler for member `signo` of `set`.
+  static inline bool WG14_SIGNALS_PREFIX(siginstall_is_member)(
+  const sigset_t *set, const int signo)
   {
-    sigset_t *ret = (sigset_t *) WG14_SIGNALS_MALLOC(sizeof(sigset_t));
-    if(ret == WG14_SIGNALS_NULLPTR)
+    if(signo == SIGKILL || signo == SIGSTOP)
     {
-      return WG14_SIGNALS_NULLPTR;
+      return false;
+    }
+#ifdef __FILC__
+    if(zis_unsafe_signal_for_handlers(signo))
+    {
+      return false;
     }
+#endif
+    return WG14_SIGNALS_SIGISMEMBER(set, signo);
+  }
+
+  void *WG14_SIGNALS_PREFIX(siginstall)(const sigset_t *guarded)
+  {
+    sigset_t set;
     if(guarded == WG14_SIGNALS_NULLPTR)
     {
       // "All the standard POSIX signals" (the documented contract for a null
@@ -538,7 +1833,7 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
       // installed (analysis.md RTIM). Fill first, then exclude those ranges,
       // so the semantics stay "all signals minus the internal/realtime ones"
       // rather than "whatever the helper sets happen to contain".
-      WG14_SIGNALS_SIGFILLSET(ret);
+      WG14_SIGNALS_SIGFILLSET(&set);
       // The realtime range. SIGRTMIN/SIGRTMAX may be compile-time constants
       // (musl, BSD) or, on glibc, the runtime functions
       // __libc_current_sigrtmin()/__libc_current_sigrtmax() -- both forms are
@@ -546,13 +1841,13 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
 #if defined(SIGRTMIN) && defined(SIGRTMAX)
       for(int signo = (int) SIGRTMIN; signo <= (int) SIGRTMAX; signo++)
       {
-        WG14_SIGNALS_SIGDELSET(ret, signo);
+        WG14_SIGNALS_SIGDELSET(&set, signo);
       }
 #endif
     }
     else
     {
-      *ret = *guarded;
+      set = *guarded;
     }
     // libc-internal signals are never installable, regardless of which guarded
     // set was supplied: SIGCANCEL/SIGSETXID are glibc's own
@@ -561,62 +1856,47 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
     // inputs too -- a caller doing WG14_SIGNALS_SIGFILLSET(&set);
     // siginstall(&set) would otherwise hit them through the same handle.
 #ifdef SIGCANCEL
-    WG14_SIGNALS_SIGDELSET(ret, SIGCANCEL);
+    WG14_SIGNALS_SIGDELSET(&set, SIGCANCEL);
 #endif
 #ifdef SIGSETXID
-    WG14_SIGNALS_SIGDELSET(ret, SIGSETXID);
+    WG14_SIGNALS_SIGDELSET(&set, SIGSETXID);
 #endif
+    size_t count = 0;
     for(int signo = 1; signo < NSIG; signo++)
     {
-      if(signo == SIGKILL || signo == SIGSTOP)
+      if(WG14_SIGNALS_PREFIX(siginstall_is_member)(&set, signo))
       {
-        continue;
-      }
-#ifdef __FILC__
-      if(zis_unsafe_signal_for_handlers(signo))
-      {
-        continue;
+        count++;
       }
-#endif
-      if(WG14_SIGNALS_SIGISMEMBER(ret, signo))
+    }
+    struct WG14_SIGNALS_PREFIX(siginstall_handle_t) *ret =
+    (struct WG14_SIGNALS_PREFIX(siginstall_handle_t) *) WG14_SIGNALS_MALLOC(
+    WG14_SIGNALS_SIGINSTALL_HANDLE_HEADER_SIZE + count * sizeof(int));
+    if(ret == WG14_SIGNALS_NULLPTR)
+    {
+      return WG14_SIGNALS_NULLPTR;
+    }
+    ret->guarded = set;
+    ret->count = count;
+    int *signos = WG14_SIGNALS_PREFIX(siginstall_handle_signos)(ret);
+    for(int signo = 1, n = 0; signo < NSIG; signo++)
+    {
+      if(WG14_SIGNALS_PREFIX(siginstall_is_member)(&set, signo))
       {
-        if(!WG14_SIGNALS_PREFIX(install_sighandler)(signo))
-        {
-          // Roll back the signals this call already installed: a partial
-          // install that returned NULL would otherwise leave handlers
-          // installed with no handle to uninstall them, and a subsequent
-          // siginstall would double-count them (analysis.md 3.8). Every signal
-          // processed before this failure was successfully installed (the loop
-          // returns at the first failure), so uninstalling exactly the members
-          // of `ret` below this signo undoes this call's contribution.
-          // uninstall_sighandler() always succeeds and decrements the signal's
-          // install_count, fully uninstalling only when it reaches zero, so a
-          // signal that was already installed by an earlier siginstall stays
-          // installed at its previous reference count.
-          const int errcode = errno;
-          for(int rollback_signo = 1; rollback_signo < signo; rollback_signo++)
-          {
-            if(rollback_signo == SIGKILL || rollback_signo == SIGSTOP)
-            {
-              continue;
-            }
-#ifdef __FILC__
-            if(zis_unsafe_signal_for_handlers(rollback_signo))
-            {
-              continue;
-            }
-#endif
-            if(WG14_SIGNALS_SIGISMEMBER(ret, rollback_signo))
-            {
-              (void) WG14_SIGNALS_PREFIX(uninstall_sighandler)(rollback_signo);
-            }
-          }
-          WG14_SIGNALS_FREE(ret);
-          errno = errcode;
-          return WG14_SIGNALS_NULLPTR;
-        }
+        signos[n++] = signo;
       }
     }
+    if(!WG14_SIGNALS_PREFIX(install_sighandlers)(signos, count))
+    {
+      // Nothing of this call remains installed (analysis.md 3.8): a partial
+      // install that returned NULL would leave handlers installed with no
+      // handle to uninstall them, and a subsequent siginstall would
+      // double-count them.
+      const int errcode = errno;
+      WG14_SIGNALS_FREE(ret);
+      errno = errcode;
+      return WG14_SIGNALS_NULLPTR;
+    }
     return ret;
   }
 
@@ -627,21 +1907,21 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
       errno = EINVAL;
       return -1;
     }
-    sigset_t *sigset = (sigset_t *) ss;
-    for(int signo = 1; signo < NSIG; signo++)
+    struct WG14_SIGNALS_PREFIX(siginstall_handle_t) *handle =
+    (struct WG14_SIGNALS_PREFIX(siginstall_handle_t) *) ss;
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    LOCK(state->lock);
+    const bool had_handlers = (state->sighandlers_count != 0);
+    WG14_SIGNALS_PREFIX(uninstall_sighandlers_locked)(
+    state, WG14_SIGNALS_PREFIX(siginstall_handle_signos)(handle),
+    handle->count);
+    WG14_SIGNALS_PREFIX(sig_reclaim)(state);
+    if(had_handlers && state->sighandlers_count == 0)
     {
-      if(signo == SIGKILL || signo == SIGSTOP)
-      {
-        continue;
-      }
-      if(WG14_SIGNALS_SIGISMEMBER(sigset, signo))
-      {
-        if(!WG14_SIGNALS_PREFIX(uninstall_sighandler)(signo))
-        {
-          return -1;
-        }
-      }
+      (void) WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)();
     }
+    UNLOCK(state->lock);
     WG14_SIGNALS_FREE(ss);
     return 0;
   }
@@ -683,29 +1963,32 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
       errno = EINVAL;
       return WG14_SIGNALS_NULLPTR;
     }
-    const size_t sigset_t_size =
-    (sizeof(sigset_t) +
-     sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *) - 1) &
-    ~(sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *) - 1);
-    void *ret = WG14_SIGNALS_MALLOC(
-    sigset_t_size + (signo_count + 1) * sizeof(struct WG14_SIGNALS_PREFIX(
-                                        global_signal_decider_t) *));
+    const size_t bytes =
+    WG14_SIGNALS_DECIDER_HANDLE_HEADER_SIZE +
+    signo_count * sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t));
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) *ret =
+    (signo_count == 1)
+    ? (struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) *)
+      WG14_SIGNALS_PREFIX(sig_pool_alloc)(&state->decider_pool,
+                                          WG14_SIGNALS_DECIDER_POOL_STRIDE,
+                                          WG14_SIGNALS_DECIDER_POOL_CAPACITY)
+    : WG14_SIGNALS_NULLPTR;
     if(ret == WG14_SIGNALS_NULLPTR)
     {
-      return WG14_SIGNALS_NULLPTR;
+      ret = (struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) *)
+      WG14_SIGNALS_CALLOC(1, bytes);
+      if(ret == WG14_SIGNALS_NULLPTR)
+      {
+        return WG14_SIGNALS_NULLPTR;
+      }
     }
-    WG14_SIGNALS_MEMSET(ret, 0,
-                        sigset_t_size +
-                        (signo_count + 1) * sizeof(struct WG14_SIGNALS_PREFIX(
-                                            global_signal_decider_t) *));
-    *(sigset_t *) ret = *guarded;
-    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **retp =
-    (struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **) ((char *) ret +
-                                                              sigset_t_size);
-
-    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-    WG14_SIGNALS_PREFIX(sig_global_state)();
-    for(int signo = 1; signo < NSIG; signo++)
+    ret->retired.allocation = ret;
+    ret->count = signo_count;
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *nodes =
+    WG14_SIGNALS_PREFIX(signal_decider_handle_nodes)(ret);
+    for(int signo = 1, n = 0; signo < NSIG; signo++)
     {
       if(signo == SIGKILL || signo == SIGSTOP)
       {
@@ -713,54 +1996,50 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
       }
       if(WG14_SIGNALS_SIGISMEMBER(guarded, signo))
       {
-        LOCK(state->lock);
-        WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-        it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-        &state->signo_to_sighandler_map, signo);
-        if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
-        {
-          // We don't have a handler installed for that signal: record the NULL
-          // slot and report the warning after releasing the lock --
-          // WG14_SIGNALS_STDERR_PRINTF is slow and can itself trigger a signal
-          // delivery while state->lock is held (plans/analysis.md SDCF, SPIN).
-          *retp++ = WG14_SIGNALS_NULLPTR;
-          UNLOCK(state->lock);
-          WG14_SIGNALS_STDERR_PRINTF(
-          "WARNING: signal_decider_create() installing decider for signal %d "
-          "but "
-          "handler was never installed for that signal.\n",
-          signo);
-          continue;
-        }
-        struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i =
-        (struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *)
-        WG14_SIGNALS_CALLOC(
-        1, sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t)));
-        if(i == WG14_SIGNALS_NULLPTR)
-        {
-          int errcode = errno;
-          UNLOCK(state->lock);
-          WG14_SIGNALS_PREFIX(signal_decider_destroy)(ret);
-          errno = errcode;
-          return WG14_SIGNALS_NULLPTR;
-        }
-        i->refcount = 1;
-        i->decider = decider;
-        i->value = value;
-        if(callfirst)
-        {
-          LIST_INSERT_FRONT(signo_to_sighandler_map_t_value(it)->global_handler,
-                            i);
-        }
-        else
-        {
-          LIST_INSERT_BACK(signo_to_sighandler_map_t_value(it)->global_handler,
-                           i);
-        }
-        *retp++ = i;
-        UNLOCK(state->lock);
+        nodes[n].signo = signo;
+        nodes[n].decider = decider;
+        nodes[n].value = value;
+        n++;
       }
     }
+
+    for(size_t n = 0; n < signo_count; n++)
+    {
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i = &nodes[n];
+      // Only this signal's container is locked, so creates and destroys for
+      // different signals, and raises of any signal, proceed concurrently.
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+      WG14_SIGNALS_PREFIX(sighandler_info_lock)(state, i->signo);
+      if(item == WG14_SIGNALS_NULLPTR)
+      {
+        // We don't have a handler installed for that signal: leave the node
+        // unpublished and report the warning with no lock held --
+        // WG14_SIGNALS_STDERR_PRINTF is slow and can itself trigger a signal
+        // delivery (plans/analysis.md SDCF, SPIN).
+        WG14_SIGNALS_STDERR_PRINTF(
+        "WARNING: signal_decider_create() installing decider for signal %d "
+        "but "
+        "handler was never installed for that signal.\n",
+        i->signo);
+        continue;
+      }
+      i->id = 1 + atomic_fetch_add_explicit(
+                  &state->next_decider_id, 1,
+                  WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      if(!WG14_SIGNALS_PREFIX(sighandler_info_republish)(state, item, i,
+                                                           callfirst))
+      {
+        int errcode = errno;
+        i->id = 0;
+        UNLOCK(item->lock);
+        WG14_SIGNALS_PREFIX(signal_decider_destroy)(ret);
+        errno = errcode;
+        return WG14_SIGNALS_NULLPTR;
+      }
+      UNLOCK(item->lock);
+    }
+    // The snapshots replaced above are freed in one pass.
+    WG14_SIGNALS_PREFIX(sig_reclaim_bounded)(state);
     return ret;
   }
 
@@ -772,100 +2051,75 @@ static int WG14_SIGNALS_PREFIX(sig_global_tss_state_destroy)(void)
       return -1;
     }
     // The handle is always recognised (a non-NULL opaque pointer) and is
-    // always freed below, so the destroy succeeds -- 0 per the N3924 7.14.2.8
-    // return contract ("If successful, this function returns zero"). The
-    // former -1-on-no-matching-slots was a misleading error signal: it fired
-    // exactly when the guarded signals have no live decider nodes (e.g. a
-    // partially built handle from signal_decider_create()'s failure path whose
-    // slots are all NULL) even though the handle was removed
+    // always released below, so the destroy succeeds -- 0 per the N3924
+    // 7.14.2.8 return contract ("If successful, this function returns zero").
+    // The former -1-on-no-matching-slots was a misleading error signal: it
+    // fired exactly when the guarded signals have no live decider nodes (e.g.
+    // a partially built handle from signal_decider_create()'s failure path
+    // whose nodes are all unpublished) even though the handle was removed
     // (plans/analysis.md SDCF).
     int ret = 0;
     struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
     WG14_SIGNALS_PREFIX(sig_global_state)();
-    const sigset_t *guarded = (const sigset_t *) p;
-    const size_t sigset_t_size =
-    (sizeof(sigset_t) +
-     sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *) - 1) &
-    ~(sizeof(struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *) - 1);
-    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **retp =
-    (struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **) ((char *) p +
-                                                              sigset_t_size);
-    for(int signo = 1; signo < NSIG; signo++)
+    struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) *handle =
+    (struct WG14_SIGNALS_PREFIX(signal_decider_handle_t) *) p;
+    struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *nodes =
+    WG14_SIGNALS_PREFIX(signal_decider_handle_nodes)(handle);
+    for(size_t n = 0; n < handle->count; n++)
     {
-      if(signo == SIGKILL || signo == SIGSTOP)
+      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *node = &nodes[n];
+      if(node->id == 0)
       {
         continue;
       }
-      LOCK(state->lock);
-      WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-      it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-      &state->signo_to_sighandler_map, signo);
-      if(!WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+      WG14_SIGNALS_PREFIX(sighandler_info_lock)(state, node->signo);
+      // Mark the node dead first, so a raise already walking a stale snapshot
+      // which holds it -- including a raise which called this function from a
+      // decider -- skips it from now on.
+      atomic_store_explicit(&node->dead, 1,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      // The node may have been orphaned by a siguninstall that retired its
+      // original container, leaving this signal's new container (if any)
+      // without it (analysis.md 2.23/AA1).
+      if(item != WG14_SIGNALS_NULLPTR &&
+         WG14_SIGNALS_PREFIX(sighandler_info_has_decider)(item, node))
       {
-        while(signo_to_sighandler_map_t_value(it)->deferred_frees.front !=
-              WG14_SIGNALS_NULLPTR)
-        {
-          struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *i =
-          signo_to_sighandler_map_t_value(it)->deferred_frees.front;
-          LIST_REMOVE(signo_to_sighandler_map_t_value(it)->deferred_frees, i);
-          WG14_SIGNALS_FREE(i);
-        }
-        if(WG14_SIGNALS_SIGISMEMBER(guarded, signo))
+        // Blank the node's pair in the published snapshot, which the raise
+        // path reads without looking at the node itself.
+        const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t)
+        *snap =
+        (const struct WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_t) *)
+        atomic_load_explicit(&item->deciders,
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+        struct WG14_SIGNALS_PREFIX(global_signal_decider_t) **snapnodes =
+        WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_nodes)(snap);
+        struct WG14_SIGNALS_PREFIX(global_signal_decider_entry_t) *entries =
+        WG14_SIGNALS_PREFIX(global_signal_decider_snapshot_entries)(snap);
+        for(size_t m = 0; m < snap->count; m++)
         {
-          if(*retp != WG14_SIGNALS_NULLPTR)
+          if(snapnodes[m] == node)
           {
-            if(0 == --(*retp)->refcount)
-            {
-              // The node may have been orphaned (detached) by a siguninstall
-              // that freed its original container, leaving this signal's new
-              // container without it; only LIST_REMOVE when the node is still
-              // linked in the current container (analysis.md 2.23/AA1).
-              if(WG14_SIGNALS_PREFIX(sighandler_info_has_decider)(
-                 signo_to_sighandler_map_t_value(it), *retp))
-              {
-                LIST_REMOVE(signo_to_sighandler_map_t_value(it)->global_handler,
-                            *retp);
-              }
-              else
-              {
-                (*retp)->next = (*retp)->prev = WG14_SIGNALS_NULLPTR;
-              }
-              // The node is no longer referenced by any container or in-flight
-              // raise (the map-entry branch is only reached when no raise holds
-              // it, since the raise path bumps refcount under the same lock
-              // before its unlocked decider call), so free it now. Leaving it
-              // to the post-unlock block would decrement the refcount a second
-              // time 0 -> -1 and never free it (analysis.md 2.24/AB1).
-              WG14_SIGNALS_FREE(*retp);
-              *retp = WG14_SIGNALS_NULLPTR;
-            }
-            else
-            {
-              // He will be freed when the handler exits
-              *retp = WG14_SIGNALS_NULLPTR;
-            }
+            atomic_store_explicit(
+            &entries[m].decider, 0,
+            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
           }
         }
+        // Publish a snapshot without the node. Should that allocation fail,
+        // the blanked pair stays in the published snapshot until the next
+        // republish drops it; nothing reads a blanked pair's node.
+        (void) WG14_SIGNALS_PREFIX(sighandler_info_republish)(
+        state, item, WG14_SIGNALS_NULLPTR, false);
       }
-      UNLOCK(state->lock);
-      if(WG14_SIGNALS_SIGISMEMBER(guarded, signo))
+      if(item != WG14_SIGNALS_NULLPTR)
       {
-        if(*retp != WG14_SIGNALS_NULLPTR)
-        {
-          // The signal is not currently installed (its container was released
-          // by a siguninstall). The node may still be pinned by an in-flight
-          // raise, so only free it once its refcount reaches zero; a pinned
-          // node is retired via deferred_frees when the raise completes
-          // (analysis.md 2.23/AA1 concurrent sibling).
-          if(0 == --(*retp)->refcount)
-          {
-            WG14_SIGNALS_FREE(*retp);
-          }
-        }
-        retp++;
+        UNLOCK(item->lock);
       }
     }
-    WG14_SIGNALS_FREE(p);
+    // Blanked or orphaned, no node is reachable by a raise which starts from
+    // now on, so the handle is always retired here, all its nodes with it.
+    WG14_SIGNALS_PREFIX(sig_retire)(state, &handle->retired);
+    WG14_SIGNALS_PREFIX(sig_reclaim_bounded)(state);
     return ret;
   }
 
@@ -30,6 +30,7 @@ limitations under the License.
 
 #include <pthread.h>
 #include <signal.h>
+#include <stddef.h>  // for offsetof
 
 #include "thrd_signal_handle_common.ipp.ipp"
 
@@ -271,6 +272,9 @@ static void __attribute__((noreturn)) default_abort(void)
     rsi->internal_global_decider = WG14_SIGNALS_NULLPTR;
     rsi->internal_local_decider = WG14_SIGNALS_NULLPTR;
     rsi->internal_sighandler = WG14_SIGNALS_NULLPTR;
+    rsi->internal_reader = WG14_SIGNALS_NULLPTR;
+    rsi->internal_global_decider_id = 0;
+    rsi->internal_global_reader = 0;
   }
 
   // The base signal handler for POSIX
@@ -301,6 +305,62 @@ static void __attribute__((noreturn)) default_abort(void)
     }
   }
 
+  // A frame's guarded set is kept as a mask of bit `signo - 1` for signals 1
+  // to 63, so that stdc_raise() tests each frame, and the union of all of a
+  // thread's frames, without calling sigismember() on the caller's sigset_t.
+  // Where NSIG allows higher signals they all share bit 63, and a raise of one
+  // confirms it against the frame's sigset_t.
+  // ASYNC-SIGNAL-SAFE.
+  static inline uint64_t WG14_SIGNALS_PREFIX(frame_mask_bit)(const int signo)
+  {
+    return (uint64_t) 1 << (signo < 64 ? signo - 1 : 63);
+  }
+  // Where the C library's sigset_t layout is known the mask is read straight
+  // out of it, as testing each signal below NSIG would cost every sigguarded()
+  // call up to a hundred or so sigismember() calls.
+  static inline uint64_t
+  WG14_SIGNALS_PREFIX(frame_mask_of)(const sigset_t *signals)
+  {
+#if defined(__linux__) && !defined(__ANDROID__) && NSIG <= 65 &&               \
+defined(__SIZEOF_LONG__)
+    // glibc and musl keep signal `signo` in bit `signo - 1` of an array of
+    // unsigned longs, so signals 1 to 64 fill the first 64 bits.
+#ifdef __GLIBC__
+    const unsigned long *words = signals->__val;
+#else
+    const unsigned long *words = signals->__bits;
+#endif
+#if __SIZEOF_LONG__ == 8
+    return (uint64_t) words[0];
+#else
+    return (uint64_t) words[0] | ((uint64_t) words[1] << 32);
+#endif
+#elif defined(__FreeBSD__) || defined(__NetBSD__) || defined(__DragonFly__)
+    // Four 32 bit words, signal `signo` in bit `signo - 1`. Signals 64 and up
+    // share bit 63.
+    uint64_t mask =
+    (uint64_t) signals->__bits[0] | ((uint64_t) signals->__bits[1] << 32);
+    if((signals->__bits[2] | signals->__bits[3]) != 0)
+    {
+      mask |= (uint64_t) 1 << 63;
+    }
+    return mask;
+#elif defined(__APPLE__) || defined(__OpenBSD__)
+    // A single 32 bit word, signal `signo` in bit `signo - 1`.
+    return (uint64_t) *signals;
+#else
+    uint64_t mask = 0;
+    for(int signo = 1; signo < NSIG; signo++)
+    {
+      if(WG14_SIGNALS_SIGISMEMBER(signals, signo) == 1)
+      {
+        mask |= WG14_SIGNALS_PREFIX(frame_mask_bit)(signo);
+      }
+    }
+    return mask;
+#endif
+  }
+
   union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
   WG14_SIGNALS_PREFIX(sigguarded)(const sigset_t *signals,
                                   WG14_SIGNALS_PREFIX(sig_func_t) guarded,
@@ -323,20 +383,38 @@ static void __attribute__((noreturn)) default_abort(void)
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_per_frame_t) *old =
     tss->front,
                                                                        current;
-    WG14_SIGNALS_MEMSET(&current, 0, sizeof(current));
+    // Not the jmp_buf, the bulk of the frame, which setjmp() fills if needed.
+    WG14_SIGNALS_MEMSET(
+    &current, 0,
+    offsetof(struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_per_frame_t),
+             buf));
     current.prev = old;
     current.guarded = signals;
     current.recovery = recovery;
     current.decider = decider;
-    current.rsi.value = value;
-    if(WG14_SIGNALS_SETJMP(current.buf) != 0)
+    current.value = value;
+    current.guarded_mask = WG14_SIGNALS_PREFIX(frame_mask_of)(signals);
+    current.outer_mask = tss->guarded_mask;
+    // Without a recovery routine nothing ever longjmps here, as stdc_raise()
+    // passes a decision to call it on to the outer frames, so an "observe and
+    // resume" guard skips the context capture, most of the cost of a guard.
+    if(recovery != WG14_SIGNALS_NULLPTR)
     {
-      tss->front = old;
-      // Technically needed to ensure previous handler is active before recovery
-      // function is called, as it may raise a signal
-      atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
-      return recovery(&current.rsi);
+      if(WG14_SIGNALS_SETJMP(current.buf) != 0)
+      {
+        // Copied out first, as the recovery may itself guard and recover.
+        struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi = tss->recovery_rsi;
+        tss->front = old;
+        atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
+        tss->guarded_mask = current.outer_mask;
+        // Technically needed to ensure previous handler is active before
+        // recovery function is called, as it may raise a signal
+        atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
+        return recovery(&rsi);
+      }
     }
+    tss->guarded_mask = current.outer_mask | current.guarded_mask;
+    atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
     tss->front = &current;
     // Technically needed to ensure setjmp buffer written out before guarded
     // function is called
@@ -344,9 +422,361 @@ static void __attribute__((noreturn)) default_abort(void)
     union WG14_SIGNALS_PREFIX(stdc_siginfo_value) ret = guarded(value);
     tss->front = old;
     atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
+    tss->guarded_mask = current.outer_mask;
     return ret;
   }
 
+  // A sigguarded_regions_register() registration: a header followed by its
+  // `count` regions, in one allocation.
+  struct WG14_SIGNALS_PREFIX(sig_region_registration_t)
+  {
+    // Must be first: the limbo list frees the registration through this
+    // header, as a published table may still refer to its `guarded`.
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) retired;
+    // The next registration, or the next orphan once deregistered, under
+    // state->regions_lock.
+    struct WG14_SIGNALS_PREFIX(sig_region_registration_t) * next;
+    sigset_t guarded;
+    uint64_t guarded_mask;
+    size_t count;
+  };
+#define WG14_SIGNALS_REGION_REGISTRATION_HEADER_SIZE                           \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(sig_region_registration_t)) +           \
+    sizeof(struct WG14_SIGNALS_PREFIX(sigguarded_region)) - 1) /               \
+   sizeof(struct WG14_SIGNALS_PREFIX(sigguarded_region)) *                     \
+   sizeof(struct WG14_SIGNALS_PREFIX(sigguarded_region)))
+  static inline struct WG14_SIGNALS_PREFIX(sigguarded_region) *
+  WG14_SIGNALS_PREFIX(sig_region_registration_regions)(
+  struct WG14_SIGNALS_PREFIX(sig_region_registration_t) * reg)
+  {
+    return (struct WG14_SIGNALS_PREFIX(sigguarded_region) *) ((
+    char *) reg + WG14_SIGNALS_REGION_REGISTRATION_HEADER_SIZE);
+  }
+
+  // One region of a published table. `landing_pad` is atomic so that
+  // sigguarded_regions_deregister() can blank a deregistered region in place
+  // in the published table, which a raise then skips.
+  struct WG14_SIGNALS_PREFIX(sig_region_entry_t)
+  {
+    uintptr_t begin, end;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t landing_pad;
+    uint64_t guarded_mask;
+    // The registration's, for a signal sharing bit 63 of the mask.
+    const sigset_t *guarded;
+  };
+
+  // An immutable, published array of every registered region sorted by
+  // address, rebuilt on every registration change: a header followed by the
+  // `count` entries, in one allocation.
+  struct WG14_SIGNALS_PREFIX(sig_region_table_t)
+  {
+    // Must be first: the limbo list frees the table through this header.
+    struct WG14_SIGNALS_PREFIX(sig_retired_t) retired;
+    size_t count;
+  };
+#define WG14_SIGNALS_REGION_TABLE_HEADER_SIZE                                  \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(sig_region_table_t)) +                  \
+    sizeof(struct WG14_SIGNALS_PREFIX(sig_region_entry_t)) - 1) /              \
+   sizeof(struct WG14_SIGNALS_PREFIX(sig_region_entry_t)) *                    \
+   sizeof(struct WG14_SIGNALS_PREFIX(sig_region_entry_t)))
+  static inline struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *
+  WG14_SIGNALS_PREFIX(sig_region_table_entries)(
+  const struct WG14_SIGNALS_PREFIX(sig_region_table_t) * table)
+  {
+    return (struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *) ((
+    char *) table + WG14_SIGNALS_REGION_TABLE_HEADER_SIZE);
+  }
+
+#ifdef WG14_SIGNALS_UCONTEXT_PC
+  static int WG14_SIGNALS_PREFIX(sig_region_entry_compare)(const void *a,
+                                                          const void *b)
+  {
+    const uintptr_t x =
+    ((const struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *) a)->begin;
+    const uintptr_t y =
+    ((const struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *) b)->begin;
+    return (x > y) - (x < y);
+  }
+
+  // Publish a table of every registered region, retiring the previous one
+  // and the orphaned registrations it may refer to. Returns -1 with errno set
+  // to ENOMEM, or to EINVAL if two regions overlap, leaving the published
+  // table and the orphans as they were. The caller holds state->regions_lock.
+  static int WG14_SIGNALS_PREFIX(sig_regions_republish)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) * state)
+  {
+    size_t count = 0;
+    for(struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *reg =
+        state->region_registrations;
+        reg != WG14_SIGNALS_NULLPTR; reg = reg->next)
+    {
+      count += reg->count;
+    }
+    struct WG14_SIGNALS_PREFIX(sig_region_table_t) *table =
+    WG14_SIGNALS_NULLPTR;
+    if(count > 0)
+    {
+      table = (struct WG14_SIGNALS_PREFIX(sig_region_table_t) *)
+      WG14_SIGNALS_CALLOC(
+      1, WG14_SIGNALS_REGION_TABLE_HEADER_SIZE +
+         count * sizeof(struct WG14_SIGNALS_PREFIX(sig_region_entry_t)));
+      if(table == WG14_SIGNALS_NULLPTR)
+      {
+        errno = ENOMEM;
+        return -1;
+      }
+      table->retired.allocation = table;
+      table->count = count;
+      struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *entries =
+      WG14_SIGNALS_PREFIX(sig_region_table_entries)(table);
+      size_t idx = 0;
+      for(struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *reg =
+          state->region_registrations;
+          reg != WG14_SIGNALS_NULLPTR; reg = reg->next)
+      {
+        const struct WG14_SIGNALS_PREFIX(sigguarded_region) *regions =
+        WG14_SIGNALS_PREFIX(sig_region_registration_regions)(reg);
+        for(size_t n = 0; n < reg->count; n++, idx++)
+        {
+          entries[idx].begin = (uintptr_t) regions[n].begin;
+          entries[idx].end = (uintptr_t) regions[n].end;
+          atomic_store_explicit(
+          &entries[idx].landing_pad, (uintptr_t) regions[n].landing_pad,
+          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+          entries[idx].guarded_mask = reg->guarded_mask;
+          entries[idx].guarded = &reg->guarded;
+        }
+      }
+      WG14_SIGNALS_QSORT(entries, count, sizeof(entries[0]),
+                         WG14_SIGNALS_PREFIX(sig_region_entry_compare));
+      for(idx = 1; idx < count; idx++)
+      {
+        if(entries[idx].begin < entries[idx - 1].end)
+        {
+          WG14_SIGNALS_FREE(table);
+          errno = EINVAL;
+          return -1;
+        }
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(sig_region_table_t) *old =
+    (struct WG14_SIGNALS_PREFIX(sig_region_table_t) *) atomic_load_explicit(
+    &state->regions, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    atomic_store_explicit(&state->regions, (uintptr_t) table,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    if(old != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_PREFIX(sig_retire)(state, &old->retired);
+    }
+    while(state->region_orphans != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *reg =
+      state->region_orphans;
+      state->region_orphans = reg->next;
+      WG14_SIGNALS_PREFIX(sig_retire)(state, &reg->retired);
+    }
+    return 0;
+  }
+
+  // If the instruction `context` was interrupted at lies in a region guarding
+  // `signo`, alter `context` to resume at the region's landing pad and return
+  // true. A binary search of the published table, with no lock taken.
+  // ASYNC-SIGNAL-SAFE.
+  static bool WG14_SIGNALS_PREFIX(sig_region_redirect)(
+  struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) * tss,
+  const int signo, WG14_SIGNALS_PREFIX(stdc_siginfo_context_t) * context)
+  {
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    if(atomic_load_explicit(&state->regions,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) ==
+       0)
+    {
+      return false;
+    }
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) *reader =
+    (tss != WG14_SIGNALS_NULLPTR) ? tss->reader : WG14_SIGNALS_NULLPTR;
+    const bool announced = WG14_SIGNALS_PREFIX(sig_reader_enter)(state, reader);
+    const struct WG14_SIGNALS_PREFIX(sig_region_table_t) *table =
+    (const struct WG14_SIGNALS_PREFIX(sig_region_table_t) *)
+    atomic_load_explicit(&state->regions,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    bool ret = false;
+    if(table != WG14_SIGNALS_NULLPTR)
+    {
+      const uintptr_t pc = (uintptr_t) WG14_SIGNALS_UCONTEXT_PC(context);
+      struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *entries =
+      WG14_SIGNALS_PREFIX(sig_region_table_entries)(table);
+      // Find the first region beginning after pc.
+      size_t lo = 0, hi = table->count;
+      while(lo < hi)
+      {
+        const size_t mid = lo + (hi - lo) / 2;
+        if(entries[mid].begin <= pc)
+        {
+          lo = mid + 1;
+        }
+        else
+        {
+          hi = mid;
+        }
+      }
+      if(lo > 0)
+      {
+        struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *e = &entries[lo - 1];
+        // A blanked entry's registration may already be freed, so its
+        // `guarded` is only read once the landing pad shows it is not.
+        const uintptr_t landing_pad = atomic_load_explicit(
+        &e->landing_pad, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        if(landing_pad != 0 && pc < e->end &&
+           (e->guarded_mask & WG14_SIGNALS_PREFIX(frame_mask_bit)(signo)) !=
+           0 &&
+           (signo < 64 || WG14_SIGNALS_SIGISMEMBER(e->guarded, signo) == 1))
+        {
+          WG14_SIGNALS_UCONTEXT_PC(context) = landing_pad;
+          ret = true;
+        }
+      }
+    }
+    WG14_SIGNALS_PREFIX(sig_reader_exit)(state, reader, announced);
+    return ret;
+  }
+#endif
+
+  void *WG14_SIGNALS_PREFIX(sigguarded_regions_register)(
+  const sigset_t *signals,
+  const struct WG14_SIGNALS_PREFIX(sigguarded_region) * regions, size_t count)
+  {
+#ifndef WG14_SIGNALS_UCONTEXT_PC
+    (void) signals;
+    (void) regions;
+    (void) count;
+    errno = ENOTSUP;
+    return WG14_SIGNALS_NULLPTR;
+#else
+    if(signals == WG14_SIGNALS_NULLPTR || regions == WG14_SIGNALS_NULLPTR ||
+       count == 0)
+    {
+      errno = EINVAL;
+      return WG14_SIGNALS_NULLPTR;
+    }
+    for(size_t n = 0; n < count; n++)
+    {
+      if(regions[n].begin == WG14_SIGNALS_NULLPTR ||
+         (uintptr_t) regions[n].end <= (uintptr_t) regions[n].begin ||
+         regions[n].landing_pad == WG14_SIGNALS_NULLPTR)
+      {
+        errno = EINVAL;
+        return WG14_SIGNALS_NULLPTR;
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *reg =
+    (struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *)
+    WG14_SIGNALS_CALLOC(
+    1, WG14_SIGNALS_REGION_REGISTRATION_HEADER_SIZE +
+       count * sizeof(struct WG14_SIGNALS_PREFIX(sigguarded_region)));
+    if(reg == WG14_SIGNALS_NULLPTR)
+    {
+      errno = ENOMEM;
+      return WG14_SIGNALS_NULLPTR;
+    }
+    reg->retired.allocation = reg;
+    WG14_SIGNALS_MEMCPY(&reg->guarded, signals, sizeof(reg->guarded));
+    reg->guarded_mask = WG14_SIGNALS_PREFIX(frame_mask_of)(&reg->guarded);
+    reg->count = count;
+    WG14_SIGNALS_MEMCPY(
+    WG14_SIGNALS_PREFIX(sig_region_registration_regions)(reg), regions,
+    count * sizeof(struct WG14_SIGNALS_PREFIX(sigguarded_region)));
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    LOCK(state->regions_lock);
+    reg->next = state->region_registrations;
+    state->region_registrations = reg;
+    if(0 != WG14_SIGNALS_PREFIX(sig_regions_republish)(state))
+    {
+      const int errcode = errno;
+      state->region_registrations = reg->next;
+      UNLOCK(state->regions_lock);
+      WG14_SIGNALS_FREE(reg);
+      errno = errcode;
+      return WG14_SIGNALS_NULLPTR;
+    }
+    UNLOCK(state->regions_lock);
+    // The table replaced above is freed once no raise can be searching it.
+    WG14_SIGNALS_PREFIX(sig_reclaim_bounded)(state);
+    return reg;
+#endif
+  }
+
+  int WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(void *p)
+  {
+    if(p == WG14_SIGNALS_NULLPTR)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+#ifdef WG14_SIGNALS_UCONTEXT_PC
+    struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *reg =
+    (struct WG14_SIGNALS_PREFIX(sig_region_registration_t) *) p;
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    LOCK(state->regions_lock);
+    bool found = false;
+    for(struct WG14_SIGNALS_PREFIX(sig_region_registration_t) **pp =
+        &state->region_registrations;
+        *pp != WG14_SIGNALS_NULLPTR; pp = &(*pp)->next)
+    {
+      if(*pp == reg)
+      {
+        *pp = reg->next;
+        found = true;
+        break;
+      }
+    }
+    if(!found)
+    {
+      // Not registered, or already deregistered.
+      UNLOCK(state->regions_lock);
+      errno = EINVAL;
+      return -1;
+    }
+    // Blank the registration's regions in the published table, so that no
+    // raise from now on resumes at their landing pads even should the table
+    // without them fail to allocate. The next republish drops them.
+    const struct WG14_SIGNALS_PREFIX(sig_region_table_t) *table =
+    (const struct WG14_SIGNALS_PREFIX(sig_region_table_t) *)
+    atomic_load_explicit(&state->regions,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(table != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(sig_region_entry_t) *entries =
+      WG14_SIGNALS_PREFIX(sig_region_table_entries)(table);
+      for(size_t n = 0; n < table->count; n++)
+      {
+        if(entries[n].guarded == &reg->guarded)
+        {
+          atomic_store_explicit(
+          &entries[n].landing_pad, 0,
+          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+        }
+      }
+    }
+    // The registration is retired by the first republish to succeed, as
+    // until then the published table still refers to its `guarded`. Removing
+    // regions cannot make two overlap, so only ENOMEM can defer it.
+    reg->next = state->region_orphans;
+    state->region_orphans = reg;
+    (void) WG14_SIGNALS_PREFIX(sig_regions_republish)(state);
+    UNLOCK(state->regions_lock);
+    WG14_SIGNALS_PREFIX(sig_reclaim_bounded)(state);
+    return 0;
+#else
+    // Registration always fails here, so no handle can be registered.
+    errno = EINVAL;
+    return -1;
+#endif
+  }
+
   // You must NOT do anything async signal unsafe in here!
   bool WG14_SIGNALS_PREFIX(stdc_raise)(
   int signo, WG14_SIGNALS_PREFIX(stdc_siginfo_siginfo_t) * info,
@@ -393,22 +823,36 @@ static void __attribute__((noreturn)) default_abort(void)
     }
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
     WG14_SIGNALS_PREFIX(sig_global_tss_state)();
+#ifdef WG14_SIGNALS_UCONTEXT_PC
+    // A guarded region holds the interrupted instruction itself, so it is
+    // innermost of all.
+    if(raw_context != WG14_SIGNALS_NULLPTR &&
+       WG14_SIGNALS_PREFIX(sig_region_redirect)(tss, signo, raw_context))
+    {
+      return true;
+    }
+#endif
+    // One test for a signal no frame guards, the common case for a raise
+    // meant for the global deciders.
+    const uint64_t bit = WG14_SIGNALS_PREFIX(frame_mask_bit)(signo);
     struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_per_frame_t) *frame =
-    tss->front;
+    ((tss->guarded_mask & bit) != 0) ? tss->front : WG14_SIGNALS_NULLPTR;
     while(frame != WG14_SIGNALS_NULLPTR)
     {
-      if(WG14_SIGNALS_SIGISMEMBER(frame->guarded, signo))
+      if((frame->guarded_mask & bit) != 0 &&
+         (signo < 64 || WG14_SIGNALS_SIGISMEMBER(frame->guarded, signo) == 1))
       {
         // With SA_NODEFER a second delivery of a guarded signal re-enters here
         // on the same frame while the outer decider is still executing. A
-        // shared `frame->rsi` would be overwritten mid-call (analysis NSTR), so
-        // give each raise its own `rsi`; the value is the frame's (pre-set by
-        // sigguarded). `frame->rsi` is written only when recovery is requested,
-        // so the recovery routine (read post-longjmp from the sigguarded frame)
-        // sees exactly the raising raise's info.
+        // shared `rsi` would be overwritten mid-call (analysis NSTR), so give
+        // each raise its own `rsi`; the value is the frame's (set by
+        // sigguarded). `tss->recovery_rsi` is written only when recovery is
+        // requested, immediately before the longjmp, so the recovery routine
+        // (copied out post-longjmp by the sigguarded frame) sees exactly the
+        // raising raise's info.
         struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi;
         WG14_SIGNALS_PREFIX(prepare_rsi)(&rsi, signo, info, raw_context);
-        rsi.value = frame->rsi.value;
+        rsi.value = frame->value;
         // In case they wish to abandon
         rsi.internal_local_decider = frame;
         switch(frame->decider(&rsi))
@@ -428,75 +872,60 @@ static void __attribute__((noreturn)) default_abort(void)
             frame = frame->prev;
             continue;
           }
-          // Copy the siginfo into the storage in the frame for recovery to use
-          frame->rsi = rsi;
+          // Hand the siginfo over for the recovery to use
+          tss->recovery_rsi = rsi;
           WG14_SIGNALS_LONGJMP(frame->buf, 1);
         }
       }
       frame = frame->prev;
     }
 
+    // The global deciders are dispatched without taking state->lock: this
+    // raise announces itself as a reader, walks the signal's published decider
+    // snapshot, and withdraws its announcement, so concurrent raises on other
+    // threads never contend on a shared cache line here.
     struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
     WG14_SIGNALS_PREFIX(sig_global_state)();
-    LOCK(state->lock);
-    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-    &state->signo_to_sighandler_map, signo);
-    if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+    if(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals, signo))
     {
       // We don't have a handler installed for that signal
-      UNLOCK(state->lock);
       return false;
     }
+    // Hold on to the reader record itself: with fallback TLS a concurrent final
+    // siguninstall may destroy this thread's per-thread state mid-raise.
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) *reader =
+    (tss != WG14_SIGNALS_NULLPTR) ? tss->reader : WG14_SIGNALS_NULLPTR;
+    const bool announced = WG14_SIGNALS_PREFIX(sig_reader_enter)(state, reader);
     struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
-    signo_to_sighandler_map_t_value(it);
+    WG14_SIGNALS_PREFIX(sighandler_info_lookup)(state, signo);
+    if(item == WG14_SIGNALS_NULLPTR)
+    {
+      // We don't have a handler installed for that signal
+      WG14_SIGNALS_PREFIX(sig_reader_exit)(state, reader, announced);
+      return false;
+    }
     struct sigaction sa = item->old_handler;
+    if(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->decider_signals, signo))
+    {
+      // Installed without any global decider: hand straight off.
+      WG14_SIGNALS_PREFIX(sig_reader_exit)(state, reader, announced);
+      WG14_SIGNALS_PREFIX(invoke_sigaction)(&sa, signo, info, raw_context);
+      return true;
+    }
     struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi;
     WG14_SIGNALS_PREFIX(prepare_rsi)(&rsi, signo, info, raw_context);
-    // Take a reference on the container for the duration of the raise so a
-    // concurrent siguninstall cannot free it while we are unlocked inside a
-    // decider call (analysis.md 2.2).
-    item->lifetime_refcount++;
-    if(item->global_handler.front != WG14_SIGNALS_NULLPTR)
-    {
-      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *current =
-      item->global_handler.front;
-      do
-      {
-        rsi.value = current->value;
-        current->refcount++;
-        UNLOCK(state->lock);
-        // In case they wish to abandon
-        rsi.internal_sighandler = item;
-        rsi.internal_global_decider = current;
-        const enum WG14_SIGNALS_PREFIX(sig_decision) res =
-        current->decider(&rsi);
-        LOCK(state->lock);
-        if(0 == --current->refcount)
-        {
-          // Add to free later list
-          struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *to_free_later =
-          current;
-          current = current->next;
-          LIST_REMOVE(item->global_handler, to_free_later);
-          LIST_INSERT_BACK(item->deferred_frees, to_free_later);
-        }
-        else
-        {
-          current = current->next;
-        }
-        if(res)
-        {
-          WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-          UNLOCK(state->lock);
-          return true;
-        }
-      } while(current != WG14_SIGNALS_NULLPTR);
+    rsi.internal_reader = reader;
+    rsi.internal_global_reader = announced ? 1 : 0;
+    const bool res =
+    WG14_SIGNALS_PREFIX(sighandler_info_invoke_deciders)(state, item, &rsi);
+    WG14_SIGNALS_PREFIX(sig_reader_exit)(
+    state, reader, (rsi.internal_global_reader & 1) != 0);
+    if(res)
+    {
+      return true;
     }
     // None of our deciders want this, so call previously installed signal
     // handler
-    WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-    UNLOCK(state->lock);
     WG14_SIGNALS_PREFIX(invoke_sigaction)(&sa, signo, info, raw_context);
     return true;
   }
@@ -519,22 +948,21 @@ static void __attribute__((noreturn)) default_abort(void)
         }
         // Pop the top most sigguarded()
         tss->front = tss->front->prev;
+        atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
+        tss->guarded_mask = rsi->internal_local_decider->outer_mask;
       }
-      if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR ||
-         rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
+      if((rsi->internal_global_reader & 1) != 0)
       {
-        struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-        WG14_SIGNALS_PREFIX(sig_global_state)();
-        LOCK(state->lock);
-        if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_sighandler->lifetime_refcount--;
-        }
+        // The decider may never return into the raise, so withdraw the
+        // raise's read-side announcement rather than stall reclamation.
+        // Note which decider this is first: its node may be reclaimed
+        // before sigdecider_abandon_resume() resumes the walk after it.
         if(rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
         {
-          rsi->internal_global_decider->refcount--;
+          rsi->internal_global_decider_id = rsi->internal_global_decider->id;
         }
-        UNLOCK(state->lock);
+        WG14_SIGNALS_PREFIX(sig_reader_exit)
+        (WG14_SIGNALS_PREFIX(sig_global_state)(), rsi->internal_reader, true);
       }
       rsi->internal_decider_is_abandoned = true;
     }
@@ -556,23 +984,18 @@ static void __attribute__((noreturn)) default_abort(void)
           assert(tss->front == rsi->internal_local_decider->prev);
           WG14_SIGNALS_ABORT();
         }
+        tss->guarded_mask = rsi->internal_local_decider->outer_mask |
+                            rsi->internal_local_decider->guarded_mask;
+        atomic_signal_fence(WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
         tss->front = rsi->internal_local_decider;
       }
-      if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR ||
-         rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
+      if((rsi->internal_global_reader & 1) != 0)
       {
-        struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-        WG14_SIGNALS_PREFIX(sig_global_state)();
-        LOCK(state->lock);
-        if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_sighandler->lifetime_refcount++;
-        }
-        if(rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_global_decider->refcount++;
-        }
-        UNLOCK(state->lock);
+        // Announce afresh: what the raise was walking may have been reclaimed
+        // meanwhile, so also flag the walk to re-resolve it.
+        const bool announced = WG14_SIGNALS_PREFIX(sig_reader_enter)(
+        WG14_SIGNALS_PREFIX(sig_global_state)(), rsi->internal_reader);
+        rsi->internal_global_reader = (unsigned char) (announced ? 3 : 2);
       }
       rsi->internal_decider_is_abandoned = false;
     }
@@ -686,18 +686,19 @@ extern "C"
       if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR ||
          rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
       {
-        struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-        WG14_SIGNALS_PREFIX(sig_global_state)();
-        LOCK(state->lock);
-        if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR)
+        if((rsi->internal_global_reader & 1) != 0)
         {
-          rsi->internal_sighandler->lifetime_refcount--;
-        }
-        if(rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_global_decider->refcount--;
+          // The decider may never return into the pass, so withdraw the
+          // pass's read-side announcement rather than stall reclamation.
+          // Note which decider this is first: its node may be reclaimed
+          // before sigdecider_abandon_resume() resumes the walk after it.
+          if(rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
+          {
+            rsi->internal_global_decider_id = rsi->internal_global_decider->id;
+          }
+          WG14_SIGNALS_PREFIX(sig_reader_exit)
+          (WG14_SIGNALS_PREFIX(sig_global_state)(), rsi->internal_reader, true);
         }
-        UNLOCK(state->lock);
         // Pop the top most sigguarded()
         if(tss->front != WG14_SIGNALS_NULLPTR)
         {
@@ -740,21 +741,13 @@ extern "C"
         }
         tss->front = rsi->internal_local_decider;
       }
-      if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR ||
-         rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
+      if((rsi->internal_global_reader & 1) != 0)
       {
-        struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
-        WG14_SIGNALS_PREFIX(sig_global_state)();
-        LOCK(state->lock);
-        if(rsi->internal_sighandler != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_sighandler->lifetime_refcount++;
-        }
-        if(rsi->internal_global_decider != WG14_SIGNALS_NULLPTR)
-        {
-          rsi->internal_global_decider->refcount++;
-        }
-        UNLOCK(state->lock);
+        // Announce afresh: what the pass was walking may have been reclaimed
+        // meanwhile, so also flag the walk to re-resolve it.
+        const bool announced = WG14_SIGNALS_PREFIX(sig_reader_enter)(
+        WG14_SIGNALS_PREFIX(sig_global_state)(), rsi->internal_reader);
+        rsi->internal_global_reader = (unsigned char) (announced ? 3 : 2);
       }
       rsi->internal_decider_is_abandoned = false;
     }
@@ -808,122 +801,90 @@ extern "C"
       // Not a supported exception code
       return EXCEPTION_CONTINUE_SEARCH;
     }
+    // The global deciders are dispatched without taking state->lock; see
+    // sighandler_info_invoke_deciders().
     struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
     WG14_SIGNALS_PREFIX(sig_global_state)();
-    LOCK(state->lock);
-    WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_get)(
-    &state->signo_to_sighandler_map, signo);
-    if(WG14_SIGNALS_PREFIX(signo_to_sighandler_map_t_is_end)(it))
+    struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
+    WG14_SIGNALS_PREFIX(sig_global_tss_state)();
+    bool res = false;
+    // A signal with no handler installed, or installed without any global
+    // decider, has nothing to walk: skip the read side altogether. Either way
+    // this is then handled exactly like a pass no decider claimed below.
+    if(WG14_SIGNALS_PREFIX(sig_mask_test)(&state->decider_signals, signo))
     {
-      UNLOCK(state->lock);
-      // We don't have a handler installed for that signal. If this exception
-      // is one of OUR software raises (stdc_raise() of a signal with no
-      // installed handler/decider), continue execution so RaiseException()
-      // returns and stdc_raise() reports false, instead of the default
-      // unhandled behaviour which invokes Windows Error Reporting and
-      // terminates the process (analysis.md 2.16/W5). Genuine faults keep
-      // EXCEPTION_CONTINUE_SEARCH. Record the decision either way so the
-      // vectored continue handler's follow-up invocation for the same
-      // exception reuses it instead of re-running the pass (analysis.md
-      // 3.15/V5).
-      const long raise_disposition =
-      WG14_SIGNALS_PREFIX(win32_unclaimed_software_raise)(record);
-      WG14_SIGNALS_PREFIX(win32_record_global_decider_decision)(
-      record, raise_disposition);
-      return raise_disposition;
+      // Hold on to the reader record itself: with fallback TLS a concurrent
+      // final siguninstall may destroy this thread's per-thread state
+      // mid-raise.
+      struct WG14_SIGNALS_PREFIX(sig_reader_t) *reader =
+      (tss != WG14_SIGNALS_NULLPTR) ? tss->reader : WG14_SIGNALS_NULLPTR;
+      const bool announced =
+      WG14_SIGNALS_PREFIX(sig_reader_enter)(state, reader);
+      struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
+      WG14_SIGNALS_PREFIX(sighandler_info_lookup)(state, signo);
+      unsigned char global_reader = announced ? 1 : 0;
+      if(item != WG14_SIGNALS_NULLPTR)
+      {
+        struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi;
+        WG14_SIGNALS_PREFIX(prepare_rsi)(&rsi, signo, ptrs);
+        rsi.internal_reader = reader;
+        rsi.internal_global_reader = global_reader;
+        res =
+        WG14_SIGNALS_PREFIX(sighandler_info_invoke_deciders)(state, item, &rsi);
+        global_reader = rsi.internal_global_reader;
+      }
+      WG14_SIGNALS_PREFIX(sig_reader_exit)(state, reader,
+                                           (global_reader & 1) != 0);
     }
-    struct WG14_SIGNALS_PREFIX(sighandler_info) *item =
-    signo_to_sighandler_map_t_value(it);
-    struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi;
-    WG14_SIGNALS_PREFIX(prepare_rsi)(&rsi, signo, ptrs);
-    // Take a reference on the container for the duration of the raise so a
-    // concurrent siguninstall cannot free it while we are unlocked inside a
-    // decider call (analysis.md 2.2/W4).
-    item->lifetime_refcount++;
-    if(item->global_handler.front != WG14_SIGNALS_NULLPTR)
+    if(res)
     {
-      struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *current =
-      item->global_handler.front;
-      do
+      // If there is a most recent thread local handler, resume there
+      // instead. tss may be NULL: the per-thread state is created only by
+      // sig_global_tss_state_init() (a prior sigguarded()/stdc_raise() on
+      // this thread), and the vectored handler never initialises it, so a
+      // genuine fault on a thread that has only ever called siginstall()
+      // (or nothing) would otherwise NULL-deref tss->front inside the
+      // exception handler (analysis.md 2.10/V2). With no frame to resume,
+      // fall through to the "generally end the process" path below.
+      if(tss != WG14_SIGNALS_NULLPTR && tss->front != WG14_SIGNALS_NULLPTR)
       {
-        rsi.value = current->value;
-        current->refcount++;
-        UNLOCK(state->lock);
-        // In case they wish to abandon
-        rsi.internal_sighandler = item;
-        rsi.internal_global_decider = current;
-        const enum WG14_SIGNALS_PREFIX(sig_decision) res =
-        current->decider(&rsi);
-        LOCK(state->lock);
-        if(0 == --current->refcount)
-        {
-          // Add to free later list
-          struct WG14_SIGNALS_PREFIX(global_signal_decider_t) *to_free_later =
-          current;
-          current = current->next;
-          LIST_REMOVE(item->global_handler, to_free_later);
-          LIST_INSERT_BACK(item->deferred_frees, to_free_later);
-        }
-        else
-        {
-          current = current->next;
-        }
-        if(res)
-        {
-          WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-          UNLOCK(state->lock);
-          struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
-          WG14_SIGNALS_PREFIX(sig_global_tss_state)();
-          // If there is a most recent thread local handler, resume there
-          // instead. tss may be NULL: the per-thread state is created only by
-          // sig_global_tss_state_init() (a prior sigguarded()/stdc_raise() on
-          // this thread), and the vectored handler never initialises it, so a
-          // genuine fault on a thread that has only ever called siginstall()
-          // (or nothing) would otherwise NULL-deref tss->front inside the
-          // exception handler (analysis.md 2.10/V2). With no frame to resume,
-          // fall through to the "generally end the process" path below.
-          if(tss != WG14_SIGNALS_NULLPTR && tss->front != WG14_SIGNALS_NULLPTR)
-          {
-            longjmp(tss->front->buf, 1);
-          }
-          // This will generally end the process. Record the decision so the
-          // vectored continue handler's follow-up invocation for the same
-          // exception reuses it instead of re-running the deciders
-          // (analysis.md 3.15/V5).
-          WG14_SIGNALS_PREFIX(win32_record_global_decider_decision)(
-          record, EXCEPTION_CONTINUE_EXECUTION);
-          return EXCEPTION_CONTINUE_EXECUTION;
-        }
-      } while(current != WG14_SIGNALS_NULLPTR);
+        longjmp(tss->front->buf, 1);
+      }
+      // This will generally end the process. Record the decision so the
+      // vectored continue handler's follow-up invocation for the same
+      // exception reuses it instead of re-running the deciders
+      // (analysis.md 3.15/V5).
+      WG14_SIGNALS_PREFIX(win32_record_global_decider_decision)(
+      record, EXCEPTION_CONTINUE_EXECUTION);
+      return EXCEPTION_CONTINUE_EXECUTION;
     }
-    // None of our deciders want this. A software raise (stdc_raise()) that no
-    // global decider claimed must return false to the caller, not reach WER:
-    // the installed map entry means only that a handler is registered for the
+    // None of our deciders want this, or we don't have a handler installed
+    // for that signal. A software raise (stdc_raise()) that no global decider
+    // claimed must return false to the caller, not reach WER (analysis.md
+    // 2.16/W5): with no installed handler the default unhandled behaviour
+    // would invoke Windows Error Reporting and terminate the process, and an
+    // installed map entry means only that a handler is registered for the
     // signal, not that the raise should terminate the process when unclaimed
-    // (analysis.md 2.16/W5 -- the map-entry-no-decider arm of PREI). Check the
-    // raise-initiated frame before falling back to "call previously installed
-    // signal handler" below. The helper returns CONTINUE_EXECUTION for both an
-    // unclaimed raise (marking it unclaimed) and a frame-claimed raise (the
-    // frame already continued it and the vectored continue handler will reuse
-    // this recorded decision) -- the frame's claim must not be overridden by a
-    // re-run of the pass (out_of_range_signo_test).
+    // (the map-entry-no-decider arm of PREI). Genuine faults keep
+    // EXCEPTION_CONTINUE_SEARCH. Check the raise-initiated frame before
+    // falling back to "call previously installed signal handler" below. The
+    // helper returns CONTINUE_EXECUTION for both an unclaimed raise (marking
+    // it unclaimed) and a frame-claimed raise (the frame already continued it
+    // and the vectored continue handler will reuse this recorded decision) --
+    // the frame's claim must not be overridden by a re-run of the pass
+    // (out_of_range_signo_test).
     const long raise_disposition =
     WG14_SIGNALS_PREFIX(win32_unclaimed_software_raise)(record);
     if(raise_disposition == EXCEPTION_CONTINUE_EXECUTION)
     {
       WG14_SIGNALS_PREFIX(win32_record_global_decider_decision)(
       record, raise_disposition);
-      WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-      UNLOCK(state->lock);
       return raise_disposition;
     }
     // Not a software raise: call previously installed signal handler. Record
     // the decision for the V5 dedup (analysis.md 3.15).
     WG14_SIGNALS_PREFIX(win32_record_global_decider_decision)(
     record, EXCEPTION_CONTINUE_SEARCH);
-    WG14_SIGNALS_PREFIX(sighandler_info_release)(item);
-    UNLOCK(state->lock);
     return EXCEPTION_CONTINUE_SEARCH;
   }
 
@@ -998,6 +959,25 @@ extern "C"
   calls the installed unhandled exception filter function if under a debugger.
   */
 
+  // The vectored exception handling path has no table driven guarded regions.
+  void *WG14_SIGNALS_PREFIX(sigguarded_regions_register)(
+  const sigset_t *signals,
+  const struct WG14_SIGNALS_PREFIX(sigguarded_region) * regions, size_t count)
+  {
+    (void) signals;
+    (void) regions;
+    (void) count;
+    errno = ENOTSUP;
+    return WG14_SIGNALS_NULLPTR;
+  }
+
+  int WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(void *p)
+  {
+    (void) p;
+    errno = EINVAL;
+    return -1;
+  }
+
   static bool WG14_SIGNALS_PREFIX(install_sighandler_impl)(
   struct WG14_SIGNALS_PREFIX(sighandler_info) * item, const int signo)
   {
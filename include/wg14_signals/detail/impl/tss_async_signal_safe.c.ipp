@@ -28,9 +28,47 @@ limitations under the License.
 #include "thread_atexit.h"
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>  // for GetCurrentProcessorNumber
+#else
+#include <unistd.h>  // for sysconf(), syscall()
+#endif
+#ifdef __linux__
+#include <fcntl.h>        // for open()
+#include <sys/syscall.h>  // for SYS_getcpu
+#endif
+#ifdef __FreeBSD__
+#include <sys/param.h>  // for __FreeBSD_version
+#if __FreeBSD_version >= 1300000
+#include <sched.h>       // for sched_getcpu()
+#include <sys/sysctl.h>  // for sysctlbyname()
+#endif
+#endif
+
+#ifndef WG14_SIGNALS_HAVE_RSEQ
+/* Whether the C library registers a restartable sequence area with the kernel
+for each thread, whose cpu_id field the kernel keeps up to date, and which is
+found at a fixed offset from the thread pointer: glibc 2.35 onwards.
+*/
+#if defined(__linux__) && defined(__GLIBC__) && defined(__has_include) &&      \
+defined(__has_builtin)
+#if __has_include(<sys/rseq.h>) && __has_builtin(__builtin_thread_pointer) &&  \
+(__GLIBC__ > 2 || __GLIBC_MINOR__ >= 35)
+#define WG14_SIGNALS_HAVE_RSEQ 1
+#endif
+#endif
+#endif
+#ifndef WG14_SIGNALS_HAVE_RSEQ
+#define WG14_SIGNALS_HAVE_RSEQ 0
+#endif
+#if WG14_SIGNALS_HAVE_RSEQ
+#include <sys/rseq.h>  // for __rseq_offset, __rseq_size
+#endif
+
 #ifdef __cplusplus
 #include <atomic>
 extern "C"
@@ -39,22 +77,6 @@ extern "C"
 #include <stdatomic.h>
 #endif
 
-// The map key is a composite of a per-thread generation counter (high 32 bits)
-// and the kernel thread id (low 32 bits), so a thread id reused after a thread
-// exited without running its exit-time deinit maps to a fresh key rather than
-// the previous incarnation's stale entry (plans/analysis.md TIDR).
-#define NAME WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t)
-#define KEY_TY uint64_t
-#define VAL_TY void *
-#define HASH_FN vt_hash_integer
-#define CMPR_FN vt_cmpr_integer
-#include "verstable.h"
-#undef CMPR_FN
-#undef HASH_FN
-#undef VAL_TY
-#undef KEY_TY
-#undef NAME
-
 #ifdef __cplusplus
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
@@ -62,102 +84,1440 @@ extern "C"
 #endif
 #endif
 
-  struct WG14_SIGNALS_PREFIX(deinit_state)
+#ifndef WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY
+  /* The slots in a new instance's thread id map, a power of two. The map
+  doubles when it would become more than half full, and once it is bigger than
+  this, halves at least when it falls below an eighth full.
+  */
+#define WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY 32
+#endif
+#ifndef WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD
+  /* How many slots from its home a key is placed at first, and so how many
+  slots a lookup always scans.
+  */
+#define WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD 16
+#endif
+
+  /* The map from thread id to value: open addressing, readable lock-free from
+  a signal handler, and written without a lock.
+
+  The key is a composite of a per-thread generation counter (high 32 bits) and
+  one plus the thread's dense index (low 32 bits, see tss_thread_index_init()
+  below), so an index reused while an earlier holder's exit-time deinit has
+  yet to run, or never will, maps to a fresh key rather than the previous
+  holder's stale entry (plans/analysis.md TIDR). Zero is never a key, as
+  generations are one-based, so it marks an empty slot.
+
+  The dense index is the key's home slot, so there is no hashing: while the
+  table has more slots than there are threads, every key sits in its home
+  slot. A key may also live anywhere within the table's probe distance of its
+  home, initially WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD slots, and a lookup scans
+  all of them rather than stopping at the first empty one. So an erase simply
+  empties its slot: there are no tombstones, and no entries are moved, which a
+  concurrent lookup could miss. Only the thread a key names ever inserts it,
+  so an insert claims an empty slot with one compare exchange on the key, then
+  publishes the value; an erase clears the value, then the key.
+
+  A key which would make the table more than half full doubles it, and an
+  erase which leaves it less than an eighth full shrinks it to a quarter full,
+  as does thread_id_to_tls_map_t_compact(). The resizer freezes the table,
+  waits for the writers already in it to leave, rehashes it into a new one and
+  publishes that. Readers never wait: a frozen table does not change, so a
+  lookup scanning it still finds what it would have. The superseded tables are
+  kept, chained from the current one, as a reader may still be scanning one.
+  Every user of a table first announces the process-wide map epoch it saw in
+  its thread's own reader record, and superseding a table advances the epoch,
+  so a resize frees the superseded tables every announcement postdates; the
+  rest wait for a later resize or compaction, or the map's destruction.
+
+  A key with no free slot within the probe distance probes on past it, first
+  widening the table's probe distance so lookups scan as far. Only its own
+  thread looks a key up, so that thread always sees the widened distance. An
+  instance created with a nonzero `max_threads` attribute gets one table, at
+  least twice that size, which never grows: inserting then never allocates,
+  and fails once `max_threads` keys are in, counted apart from the table, as
+  a key may still find a free slot beyond that.
+  */
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t)
+  {
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong key;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t val;
+  };
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * prev;
+    size_t mask;
+    // How many slots from its home a lookup scans. Only ever widened.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_size_t probe;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_size_t count;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint writers;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint frozen;
+    // Once superseded, the map epoch a reader must have announced since to
+    // not be using it. Under the map's grow_lock.
+    uintptr_t retired_epoch;
+  };
+  // The slots follow the header (no flexible array members in C++).
+#define WG14_SIGNALS_TSS_MAP_TABLE_HEADER_SIZE                                 \
+  ((sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t)) +         \
+    sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t)) - 1) /     \
+   sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t)) *           \
+   sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t)))
+  typedef struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_s)
+  {
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t table;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint grow_lock;
+    bool fixed;  // preallocated, never resized
+    // For a fixed map, the most keys it takes, and how many it holds or is
+    // inserting.
+    size_t limit;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_size_t occupancy;
+    // Under grow_lock.
+    size_t shrinks, bytes_saved;
+  } WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t);
+
+  static inline struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table)
+  {
+    return (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *) ((
+    char *) table + WG14_SIGNALS_TSS_MAP_TABLE_HEADER_SIZE);
+  }
+
+  static inline size_t WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_bytes)(
+  const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table)
+  {
+    return WG14_SIGNALS_TSS_MAP_TABLE_HEADER_SIZE +
+           (table->mask + 1) *
+           sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t));
+  }
+
+  // A thread's announcement of the map epoch it saw on entering a table, on
+  // a cache line of its own, so that lookups on different threads write no
+  // shared line. Records are kept until process exit and reused once their
+  // thread has exited.
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) * next;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint in_use;
+    // Zero when the thread is using no table, else one plus the map epoch
+    // observed on entry.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t epoch;
+    char padding[128 - 2 * sizeof(void *) - sizeof(uintptr_t)];
+  };
+
+  // The process-wide map epoch, every reader record, and how many table users
+  // without a record are in a table. Shared across translation units like the
+  // counters further below, as a thread's record serves every instance's map
+  // whichever TU created it.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uintptr_t WG14_SIGNALS_PREFIX(tss_map_epoch) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uintptr_t WG14_SIGNALS_PREFIX(tss_map_readers) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uint WG14_SIGNALS_PREFIX(tss_map_anonymous_readers) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+
+  // This thread's reader record, or NULL if it has none: until thread_init()
+  // has run on it, once it has exited, or if the record failed to allocate.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
+  WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
+#else
+WG14_SIGNALS_THREAD_LOCAL
+#endif
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *
+  WG14_SIGNALS_PREFIX(tss_map_reader_cached) = WG14_SIGNALS_NULLPTR;
+
+  // Run at thread exit: give the record back for a new thread to reuse. Any
+  // table use after this, say by another exit-time callback, is anonymous.
+  static void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_release)(void *p)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *r =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *) p;
+    WG14_SIGNALS_PREFIX(tss_map_reader_cached) = WG14_SIGNALS_NULLPTR;
+    atomic_store_explicit(&r->in_use, 0u,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+  }
+
+  // Give this thread a reader record if it has none yet. Never called from a
+  // signal handler, as it may allocate. Without one, the thread's table uses
+  // count themselves into the shared anonymous count instead, so failing to
+  // get one is not an error.
+  static void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_init)(void)
+  {
+    if(WG14_SIGNALS_PREFIX(tss_map_reader_cached) != WG14_SIGNALS_NULLPTR)
+    {
+      return;
+    }
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *r =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *)
+    atomic_load_explicit(&WG14_SIGNALS_PREFIX(tss_map_readers),
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    for(; r != WG14_SIGNALS_NULLPTR; r = r->next)
+    {
+      unsigned expected = 0;
+      if(atomic_load_explicit(
+         &r->in_use, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed) == 0 &&
+         atomic_compare_exchange_strong_explicit(
+         &r->in_use, &expected, 1u,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      r = (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *)
+      WG14_SIGNALS_CALLOC(
+      1, sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t)));
+      if(r == WG14_SIGNALS_NULLPTR)
+      {
+        return;
+      }
+      atomic_store_explicit(&r->in_use, 1u,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      uintptr_t head = atomic_load_explicit(
+      &WG14_SIGNALS_PREFIX(tss_map_readers),
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      do
+      {
+        r->next =
+        (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *) head;
+      } while(!atomic_compare_exchange_weak_explicit(
+      &WG14_SIGNALS_PREFIX(tss_map_readers), &head, (uintptr_t) r,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_release,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed));
+    }
+    void (*func)(void *) =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_release);
+    if(0 != WG14_SIGNALS_PREFIX(thread_atexit)(func, r))
+    {
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_release)(r);
+      return;
+    }
+    WG14_SIGNALS_PREFIX(tss_map_reader_cached) = r;
+  }
+
+  // ASYNC-SIGNAL-SAFE: the current table, which stays allocated until the
+  // matching unpin(). A use nested within another on the same thread, say
+  // from a signal handler, is covered by the outer one's announcement, which
+  // is older, and sets *announced false.
+  static inline struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, bool *announced)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *r =
+    WG14_SIGNALS_PREFIX(tss_map_reader_cached);
+    *announced = true;
+    // Announce, then load the table; a resizer publishes, advances the epoch,
+    // then checks the announcements. All sequentially consistent, so either
+    // the resizer sees this reader's announcement, or this reader sees the
+    // new table.
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      atomic_fetch_add_explicit(
+      &WG14_SIGNALS_PREFIX(tss_map_anonymous_readers), 1u,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    }
+    else if(atomic_load_explicit(&r->epoch, WG14_SIGNALS_ATOMIC_PREFIX
+                                            memory_order_relaxed) != 0)
+    {
+      *announced = false;
+    }
+    else
+    {
+      atomic_store_explicit(
+      &r->epoch,
+      1 + atomic_load_explicit(&WG14_SIGNALS_PREFIX(tss_map_epoch),
+                               WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst),
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    }
+    return (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load_explicit(&map->table,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+  }
+
+  static inline void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(
+  const bool announced)
+  {
+    if(!announced)
+    {
+      return;
+    }
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *r =
+    WG14_SIGNALS_PREFIX(tss_map_reader_cached);
+    if(r == WG14_SIGNALS_NULLPTR)
+    {
+      atomic_fetch_sub_explicit(
+      &WG14_SIGNALS_PREFIX(tss_map_anonymous_readers), 1u,
+      WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+      return;
+    }
+    atomic_store_explicit(&r->epoch, 0,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+  }
+
+  // The thread index half of the key, which is small and dense.
+  static inline size_t
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_hash)(uint64_t k)
+  {
+    return (size_t) (uint32_t) k;
+  }
+
+  static struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_new)(size_t capacity)
+  {
+    // All zero is an empty, unfrozen table.
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    WG14_SIGNALS_CALLOC(
+    1, WG14_SIGNALS_TSS_MAP_TABLE_HEADER_SIZE +
+       capacity *
+       sizeof(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t)));
+    if(table != WG14_SIGNALS_NULLPTR)
+    {
+      table->mask = capacity - 1;
+      atomic_store_explicit(&table->probe,
+                            (capacity < WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD)
+                            ? capacity
+                            : (size_t) WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    return table;
+  }
+
+  // A nonzero max_threads preallocates a table that never grows.
+  static bool WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_init)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, size_t max_threads)
+  {
+    size_t capacity = WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY;
+    map->fixed = (max_threads != 0);
+    map->limit = max_threads;
+    atomic_store_explicit(&map->occupancy, (size_t) 0,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(map->fixed)
+    {
+      // At most half full, so probes stay short.
+      for(capacity = 1; capacity < max_threads * 2; capacity *= 2)
+      {
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_new)(capacity);
+    if(table == WG14_SIGNALS_NULLPTR)
+    {
+      return false;
+    }
+    atomic_store_explicit(&map->table, (uintptr_t) table,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+    return true;
+  }
+
+  static void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_cleanup)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load_explicit(&map->table,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    while(table != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *prev =
+      table->prev;
+      WG14_SIGNALS_FREE(table);
+      table = prev;
+    }
+    atomic_store_explicit(&map->table, (uintptr_t) 0,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+  }
+
+  // ASYNC-SIGNAL-SAFE: returns NULL if the key is absent, or its insert has
+  // not published the value yet.
+  static void *WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, uint64_t key)
+  {
+    if((uint32_t) key == 0)
+    {
+      // A thread without an index has no entry.
+      return WG14_SIGNALS_NULLPTR;
+    }
+    bool announced;
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(map, &announced);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    const size_t home = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_hash)(key);
+    const size_t probe = atomic_load_explicit(
+    &table->probe, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    void *val = WG14_SIGNALS_NULLPTR;
+    for(size_t n = 0; n < probe; n++)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slot =
+      &slots[(home + n) & table->mask];
+      if(atomic_load_explicit(&slot->key, WG14_SIGNALS_ATOMIC_PREFIX
+                                          memory_order_acquire) == key)
+      {
+        val = (void *) atomic_load_explicit(
+        &slot->val, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        break;
+      }
+    }
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    return val;
+  }
+
+  // Enter the current table as a writer, waiting out any resize of it. Call
+  // with the map pinned.
+  static struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_enter)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map)
+  {
+    for(;;)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+      (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+      atomic_load_explicit(&map->table,
+                           WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+      // Announce, then check for a freeze; the grower freezes, then checks for
+      // announced writers. Both sequentially consistent, so at least one of
+      // the two sees the other.
+      atomic_fetch_add_explicit(
+      &table->writers, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      if(!atomic_load_explicit(&table->frozen,
+                               WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst))
+      {
+        return table;
+      }
+      atomic_fetch_sub_explicit(
+      &table->writers, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      // Until the resizer publishes the new table, or gives up.
+      while(atomic_load_explicit(&map->table, WG14_SIGNALS_ATOMIC_PREFIX
+                                              memory_order_acquire) ==
+            (uintptr_t) table &&
+            atomic_load_explicit(&table->frozen, WG14_SIGNALS_ATOMIC_PREFIX
+                                                 memory_order_acquire))
+      {
+        WG14_SIGNALS_CPU_RELAX();
+      }
+    }
+  }
+
+  static inline void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_exit)(
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table)
+  {
+    atomic_fetch_sub_explicit(&table->writers, 1,
+                              WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+  }
+
+  // Claim a free slot within the probe distance of the key's home, or if
+  // `widen` anywhere in the table, false if there is none.
+  static bool WG14_SIGNALS_PREFIX(thread_id_to_tls_map_place)(
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table,
+  uint64_t key, void *val, bool widen)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    const size_t home = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_hash)(key);
+    const size_t limit =
+    widen ? table->mask + 1
+          : atomic_load_explicit(
+            &table->probe, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    for(size_t n = 0; n < limit; n++)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slot =
+      &slots[(home + n) & table->mask];
+      if(atomic_load_explicit(&slot->key, WG14_SIGNALS_ATOMIC_PREFIX
+                                          memory_order_relaxed) != 0)
+      {
+        continue;
+      }
+      size_t probe = atomic_load_explicit(
+      &table->probe, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      while(probe < n + 1 &&
+            !atomic_compare_exchange_weak_explicit(
+            &table->probe, &probe, n + 1,
+            WG14_SIGNALS_ATOMIC_PREFIX memory_order_release,
+            WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+      }
+      unsigned long long expected = 0;
+      if(atomic_compare_exchange_strong_explicit(
+         &slot->key, &expected, (unsigned long long) key,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,
+         WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+      {
+        atomic_store_explicit(&slot->val, (uintptr_t) val,
+                              WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+        atomic_fetch_add_explicit(
+        &table->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Free the superseded tables no reader can be using any more, as every
+  // announcement postdates their superseding. Call with grow_lock held and
+  // the map unpinned by this thread.
+  static void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reclaim)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map)
+  {
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load_explicit(&map->table,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    if(table->prev == WG14_SIGNALS_NULLPTR)
+    {
+      return;
+    }
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_thread_fence(
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    if(atomic_load_explicit(&WG14_SIGNALS_PREFIX(tss_map_anonymous_readers),
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst) !=
+       0)
+    {
+      return;
+    }
+    uintptr_t oldest = UINTPTR_MAX;
+    for(struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *r =
+        (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_t) *)
+        atomic_load_explicit(&WG14_SIGNALS_PREFIX(tss_map_readers),
+                             WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+        r != WG14_SIGNALS_NULLPTR; r = r->next)
+    {
+      const uintptr_t e = atomic_load_explicit(
+      &r->epoch, WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      if(e != 0 && e < oldest)
+      {
+        oldest = e;
+      }
+    }
+    // The chain runs newest superseded first, so once one table can be freed
+    // so can every older one.
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) **pp =
+    &table->prev;
+    while(*pp != WG14_SIGNALS_NULLPTR && (*pp)->retired_epoch >= oldest)
+    {
+      pp = &(*pp)->prev;
+    }
+    while(*pp != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *prev = *pp;
+      *pp = prev->prev;
+      map->bytes_saved +=
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_bytes)(prev);
+      WG14_SIGNALS_FREE(prev);
+    }
+  }
+
+  // Replace the table with one twice its size, or if `shrink` with one a
+  // quarter full if that is smaller, unless another thread already has. False
+  // if out of memory. Call with the map pinned if growing, in which case the
+  // superseded table is left for the caller to reclaim once unpinned.
+  static bool WG14_SIGNALS_PREFIX(thread_id_to_tls_map_resize)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map,
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table,
+  bool shrink)
+  {
+    LOCK(map->grow_lock);
+    if(atomic_load_explicit(&map->table, WG14_SIGNALS_ATOMIC_PREFIX
+                                         memory_order_acquire) !=
+       (uintptr_t) table)
+    {
+      UNLOCK(map->grow_lock);
+      return true;
+    }
+    atomic_store_explicit(&table->frozen, 1u,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    while(atomic_load_explicit(&table->writers, WG14_SIGNALS_ATOMIC_PREFIX
+                                                memory_order_seq_cst) != 0)
+    {
+      WG14_SIGNALS_CPU_RELAX();
+    }
+    // With no writers the count is exact.
+    size_t capacity = (table->mask + 1) * 2;
+    if(shrink)
+    {
+      const size_t count = atomic_load_explicit(
+      &table->count, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      for(capacity = WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY;
+          capacity < count * 4; capacity *= 2)
+      {
+      }
+    }
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *newtable =
+    (shrink && capacity > table->mask)
+    ? WG14_SIGNALS_NULLPTR
+    : WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_new)(capacity);
+    if(newtable == WG14_SIGNALS_NULLPTR)
+    {
+      atomic_store_explicit(&table->frozen, 0u,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+      if(shrink)
+      {
+        // Already the right size.
+        WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reclaim)(map);
+      }
+      UNLOCK(map->grow_lock);
+      return shrink;
+    }
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    for(size_t n = 0; n <= table->mask; n++)
+    {
+      // No writer is in a frozen table, so every key has its value.
+      const uint64_t key = atomic_load_explicit(
+      &slots[n].key, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+      if(key != 0)
+      {
+        // The new table has room, so this cannot fail.
+        (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_place)(
+        newtable, key,
+        (void *) atomic_load_explicit(
+        &slots[n].val, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire),
+        true);
+      }
+    }
+    newtable->prev = table;
+    atomic_store_explicit(&map->table, (uintptr_t) newtable,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    // A reader announcing the epoch from here on loads the new table.
+    table->retired_epoch =
+    1 + atomic_fetch_add_explicit(&WG14_SIGNALS_PREFIX(tss_map_epoch), 1,
+                                  WG14_SIGNALS_ATOMIC_PREFIX
+                                  memory_order_seq_cst);
+    if(shrink)
+    {
+      map->shrinks++;
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reclaim)(map);
+    }
+    UNLOCK(map->grow_lock);
+    return true;
+  }
+
+  // The key must not already be in the map. False if out of memory, or if a
+  // fixed map is full.
+  static bool WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, uint64_t key, void *val)
+  {
+    if(map->fixed &&
+       atomic_fetch_add_explicit(&map->occupancy, 1,
+                                 WG14_SIGNALS_ATOMIC_PREFIX
+                                 memory_order_relaxed) >= map->limit)
+    {
+      atomic_fetch_sub_explicit(&map->occupancy, 1,
+                                WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      return false;
+    }
+    bool announced;
+    (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(map, &announced);
+    bool placed = false, grew = false;
+    for(;;)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_enter)(map);
+      // A growable table is kept at most half full, so that most keys sit in
+      // their home slot.
+      const size_t count = atomic_load_explicit(
+      &table->count, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+      placed =
+      (map->fixed || (count + 1) * 2 <= table->mask + 1) &&
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_place)(table, key, val, true);
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_exit)(table);
+      if(placed || map->fixed ||
+         !WG14_SIGNALS_PREFIX(thread_id_to_tls_map_resize)(map, table, false))
+      {
+        break;
+      }
+      grew = true;
+    }
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    if(!placed && map->fixed)
+    {
+      atomic_fetch_sub_explicit(&map->occupancy, 1,
+                                WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    if(grew)
+    {
+      // Now that this thread no longer holds up the table it superseded.
+      LOCK(map->grow_lock);
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reclaim)(map);
+      UNLOCK(map->grow_lock);
+    }
+    return placed;
+  }
+
+  // Erase the slot's entry, returning its value, or NULL if it holds none or
+  // its insert has not published the value yet.
+  static void *WG14_SIGNALS_PREFIX(thread_id_to_tls_map_clear)(
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) * table,
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) * slot)
+  {
+    void *val = (void *) atomic_exchange_explicit(
+    &slot->val, (uintptr_t) 0, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel);
+    if(val != WG14_SIGNALS_NULLPTR)
+    {
+      atomic_store_explicit(&slot->key, 0ull,
+                            WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+      atomic_fetch_sub_explicit(
+      &table->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    return val;
+  }
+
+  // Returns the erased value, or NULL if the key was absent. Shrinks the table
+  // if that left it less than an eighth full.
+  static void *WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, uint64_t key)
+  {
+    bool announced;
+    (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(map, &announced);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_enter)(map);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    const size_t home = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_hash)(key);
+    const size_t probe = atomic_load_explicit(
+    &table->probe, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    void *val = WG14_SIGNALS_NULLPTR;
+    for(size_t n = 0; n < probe; n++)
+    {
+      struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slot =
+      &slots[(home + n) & table->mask];
+      if(atomic_load_explicit(&slot->key, WG14_SIGNALS_ATOMIC_PREFIX
+                                          memory_order_acquire) == key)
+      {
+        val = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_clear)(table, slot);
+        break;
+      }
+    }
+    const bool sparse =
+    !map->fixed && table->mask + 1 > WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY &&
+    atomic_load_explicit(&table->count, WG14_SIGNALS_ATOMIC_PREFIX
+                                        memory_order_relaxed) *
+    8 <
+    table->mask + 1;
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_exit)(table);
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    if(val != WG14_SIGNALS_NULLPTR && map->fixed)
+    {
+      atomic_fetch_sub_explicit(&map->occupancy, 1,
+                                WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    if(val != WG14_SIGNALS_NULLPTR && sparse)
+    {
+      // Unpinned, so that the tables this supersedes can be freed at once.
+      // The table may have been freed since, but then it is no longer current,
+      // which is all resize() compares.
+      (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_resize)(map, table, true);
+    }
+    return val;
+  }
+
+  // Shrink the table to a quarter full, if that is smaller, and free the
+  // tables it superseded if no reader can still be using them. Not
+  // async-signal-safe.
+  static void WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_compact)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map)
+  {
+    if(map->fixed)
+    {
+      return;
+    }
+    bool announced;
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(map, &announced);
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_resize)(map, table, true);
+  }
+
+  // Erase the first entry at or after slot *pos, returning its value and
+  // advancing *pos past it, or NULL once there are no more. Start *pos at zero
+  // to erase everything, one entry per call.
+  static void *WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase_next)(
+  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) * map, size_t *pos)
+  {
+    bool announced;
+    (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(map, &announced);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_enter)(map);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    void *val = WG14_SIGNALS_NULLPTR;
+    while(val == WG14_SIGNALS_NULLPTR && *pos <= table->mask)
+    {
+      val = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_clear)(table,
+                                                           &slots[(*pos)++]);
+    }
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_writer_exit)(table);
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    if(val != WG14_SIGNALS_NULLPTR && map->fixed)
+    {
+      atomic_fetch_sub_explicit(&map->occupancy, 1,
+                                WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    }
+    return val;
+  }
+
+  struct WG14_SIGNALS_PREFIX(deinit_state)
+  {
+#ifdef __cplusplus
+    std::
+#endif
+    atomic_uint count;
+    WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val;
+  };
+#ifndef WG14_SIGNALS_TSS_VALUE_ALIGNMENT
+  /* The least alignment of an inline value slot, so that no two threads'
+  values share a cache line.
+  */
+#define WG14_SIGNALS_TSS_VALUE_ALIGNMENT 64
+#endif
+#ifndef WG14_SIGNALS_TSS_VALUE_CHUNK
+  /* How many inline values a growable instance allocates at once.
+  */
+#define WG14_SIGNALS_TSS_VALUE_CHUNK 16
+#endif
+
+  // A block of inline value slots, which start at the first suitably aligned
+  // address after this header.
+  struct WG14_SIGNALS_PREFIX(tss_value_chunk_t)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) * next;
+  };
+
+  // A for_each() call in progress, on its caller's stack.
+  struct WG14_SIGNALS_PREFIX(tss_visit_t)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_visit_t) * prev, *next;
+    // The instance's visit_epoch when it started.
+    uintptr_t epoch;
+  };
+
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) attr;
+
+    // Allocated at create, so that thread_init need not. The instance holds a
+    // reference until it is destroyed, and each registered thread another
+    // until it exits.
+    struct WG14_SIGNALS_PREFIX(deinit_state) * state;
+    // Never zero, and never reused by a later instance, even one allocated at
+    // the same address: it is what the per-thread slot cache below matches.
+    uintptr_t serial;
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) thread_id_to_tls_map;
+    // The for_each() calls visiting values, under visits_lock. An exiting
+    // thread advances visit_epoch after erasing its value, then waits for the
+    // visits which started no later before destroying it: later ones cannot
+    // find it.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint visits_lock;
+    uintptr_t visit_epoch;
+    struct WG14_SIGNALS_PREFIX(tss_visit_t) * visits;
+    // The list of live instances, under tss_instances_lock.
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * instances_prev,
+    *instances_next;
+
+    // For a nonzero attr.value_size, the storage of the values: chunks of
+    // `value_stride` byte slots, the free ones chained through their first
+    // bytes. A fixed capacity instance allocates its one chunk at create.
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_uint values_lock;
+    size_t value_stride, value_alignment;
+    struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) * value_chunks;
+    void *free_values;
+
+    // For attr.per_cpu, the `ncpus` values, one per CPU, all made at create.
+    // No thread is ever registered in the map.
+    size_t ncpus;
+    void **cpu_values;
+  };
+
+#ifndef WG14_SIGNALS_TSS_CACHE_SLOTS
+  /* How many instance -> value slots each thread caches for
+  tss_async_signal_safe_get(). A thread using more instances than this still
+  finds the rest in the map.
+  */
+#define WG14_SIGNALS_TSS_CACHE_SLOTS 8
+#endif
+
+  struct WG14_SIGNALS_PREFIX(tss_cache_slot_t)
+  {
+    uintptr_t serial;  // 0 if empty
+    void *value;
+  };
+
+  // Per-thread generation counter shared across all translation units (weak /
+  // selectany so the linker merges the per-TU definitions of a header-only
+  // build): the first library use on a thread draws a fresh generation from the
+  // process-wide counter below, so a thread index reused before its previous
+  // holder's exit-time deinit has run, or after it exited without running it,
+  // still yields a map key no previous holder used (plans/analysis.md TIDR).
+  // The cache must be shared, or two translation units would hand the same
+  // generation to two different threads whose indices collide. Async-safe TLS
+  // where the platform provides it (Linux/Windows), plain _Thread_local
+  // elsewhere (Apple fallback): the generation is assigned from outside the
+  // signal handler, so a handler-context read is of an already-primed cache
+  // (plans/analysis.md 7.3/AA8).
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
+  WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
+#else
+WG14_SIGNALS_THREAD_LOCAL
+#endif
+  WG14_SIGNALS_PREFIX(thread_id_t)
+  WG14_SIGNALS_PREFIX(tss_generation_cached) = 0;
+
+  // A single shared definition of the process-wide generation counter for all
+  // translation units (weak / selectany so the linker merges the per-TU
+  // definitions of a header-only multi-TU build): every thread's first library
+  // use draws on the same monotonic counter, so two threads can never share a
+  // generation. The `{0}` / `0` split is because C++ `std::atomic` rejects
+  // copy-initialisation from a scalar while C rejects brace-initialisation of
+  // `_Atomic` scalars.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uintptr_t WG14_SIGNALS_PREFIX(tss_generation_counter) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+
+  // A single shared definition of the process-wide instance serial counter,
+  // for the same reason as the generation counter above: two instances created
+  // from different translation units must never share a serial.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uintptr_t WG14_SIGNALS_PREFIX(tss_serial_counter) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+
+  // Every live instance, newest first, for thread_init_all(). Shared across
+  // translation units like the counters above, so that it sees instances
+  // created from any of them.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX
+  atomic_uint WG14_SIGNALS_PREFIX(tss_instances_lock) =
+#ifdef __cplusplus
+  {0};
+#else
+0;
+#endif
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *
+  WG14_SIGNALS_PREFIX(tss_instances);
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  size_t WG14_SIGNALS_PREFIX(tss_instances_count);
+
+  // Each thread's cache of the values thread_init() registered for it, so
+  // get() is a TLS read rather than a locked map lookup. Shared across
+  // translation units like the generation cache, so a value registered from
+  // one TU is found from another. Only the owning thread ever writes its
+  // slots, and only from outside a signal handler (thread_init, its exit-time
+  // deinit, destroy), so the only reader that can interleave with a write is
+  // a signal handler on the same thread: the writes below are ordered with
+  // signal fences so that it sees either no match or a complete slot. The map
+  // stays authoritative; a miss falls back to it.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
+  WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
+#else
+WG14_SIGNALS_THREAD_LOCAL
+#endif
+  struct WG14_SIGNALS_PREFIX(tss_cache_slot_t)
+  WG14_SIGNALS_PREFIX(tss_cache_slots)[WG14_SIGNALS_TSS_CACHE_SLOTS];
+
+  static void WG14_SIGNALS_PREFIX(tss_cache_store)(uintptr_t serial,
+                                                  void *value)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_cache_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(tss_cache_slots);
+    // Reuse this instance's slot, else an empty one, else evict.
+    size_t idx = (size_t) (serial % WG14_SIGNALS_TSS_CACHE_SLOTS);
+    for(size_t n = 0; n < WG14_SIGNALS_TSS_CACHE_SLOTS; n++)
+    {
+      if(slots[n].serial == serial)
+      {
+        idx = n;
+        break;
+      }
+      if(slots[n].serial == 0)
+      {
+        idx = n;
+      }
+    }
+    slots[idx].serial = 0;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_signal_fence(
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    slots[idx].value = value;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_signal_fence(
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+    slots[idx].serial = serial;
+  }
+
+  static void WG14_SIGNALS_PREFIX(tss_cache_forget)(uintptr_t serial)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_cache_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(tss_cache_slots);
+    for(size_t n = 0; n < WG14_SIGNALS_TSS_CACHE_SLOTS; n++)
+    {
+      if(slots[n].serial == serial)
+      {
+        slots[n].serial = 0;
+      }
+    }
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_signal_fence(
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_seq_cst);
+  }
+
+#ifndef WG14_SIGNALS_THREAD_INDEX_PAGES
+  /* How many pages of 4096 thread indices there may be, and so how many
+  threads may have called tss_async_signal_safe_thread_init() and not yet
+  exited at once. A page is only allocated once the ones before it are full.
+  */
+#define WG14_SIGNALS_THREAD_INDEX_PAGES 64
+#endif
+#define WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS 64
+
+  // The process-wide thread index allocator, shared across translation units
+  // for the same reason as the generation counter: two threads must never
+  // hold the same index. A page is a bitmap of 4096 bits, one per index,
+  // allocated on first use and kept until process exit. Indices are handed
+  // out lowest free first and given back when their thread exits, so they stay
+  // as dense as the number of threads alive, whatever the kernel thread ids
+  // are.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+  WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t
+  WG14_SIGNALS_PREFIX(tss_thread_index_pages)[WG14_SIGNALS_THREAD_INDEX_PAGES];
+
+  // One plus this thread's index, or zero if it has none yet. Shared across
+  // translation units like the generation cache, so a thread has one index
+  // whichever TU assigned it.
+#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
+  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
+#endif
+#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
+  WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
+#else
+WG14_SIGNALS_THREAD_LOCAL
+#endif
+  uint32_t WG14_SIGNALS_PREFIX(tss_thread_index_cached) = 0;
+
+  // One plus the lowest free index, or zero if all are taken or out of memory.
+  static uint32_t WG14_SIGNALS_PREFIX(tss_thread_index_acquire)(void)
+  {
+    for(size_t p = 0; p < WG14_SIGNALS_THREAD_INDEX_PAGES; p++)
+    {
+      WG14_SIGNALS_ATOMIC_PREFIX atomic_uintptr_t *pagep =
+      &WG14_SIGNALS_PREFIX(tss_thread_index_pages)[p];
+      uintptr_t page = atomic_load_explicit(
+      pagep, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+      if(page == 0)
+      {
+        // All zero is a page with every index free.
+        uintptr_t newpage = (uintptr_t) WG14_SIGNALS_CALLOC(
+        WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS,
+        sizeof(WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong));
+        if(newpage == 0)
+        {
+          return 0;
+        }
+        if(atomic_compare_exchange_strong_explicit(
+           pagep, &page, newpage,
+           WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,
+           WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire))
+        {
+          page = newpage;
+        }
+        else
+        {
+          // Another thread installed it first.
+          WG14_SIGNALS_FREE((void *) newpage);
+        }
+      }
+      WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong *words =
+      (WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong *) page;
+      for(size_t w = 0; w < WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS; w++)
+      {
+        unsigned long long bits = atomic_load_explicit(
+        &words[w], WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+        while(bits != ~0ull)
+        {
+          unsigned bit = 0;
+          while((bits >> bit) & 1)
+          {
+            bit++;
+          }
+          if(atomic_compare_exchange_weak_explicit(
+             &words[w], &bits, bits | (1ull << bit),
+             WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel,
+             WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
+          {
+            return (uint32_t) (1 + (p * WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS +
+                                    w) *
+                                   64 +
+                               bit);
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
+  // Run at thread exit: give the index back for a new thread to reuse.
+  static void WG14_SIGNALS_PREFIX(tss_thread_index_release)(void *idx1)
+  {
+    const size_t idx = (size_t) (uintptr_t) idx1 - 1;
+    WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong *words =
+    (WG14_SIGNALS_ATOMIC_PREFIX atomic_ullong *) atomic_load_explicit(
+    &WG14_SIGNALS_PREFIX(tss_thread_index_pages)
+    [idx / (WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS * 64)],
+    WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    atomic_fetch_and_explicit(
+    &words[(idx / 64) % WG14_SIGNALS_THREAD_INDEX_PAGE_WORDS],
+    ~(1ull << (idx % 64)), WG14_SIGNALS_ATOMIC_PREFIX memory_order_release);
+  }
+
+  // Give this thread an index if it has none yet. Never called from a signal
+  // handler, as it may allocate. The index outlives the cache: it is released
+  // by its own exit-time callback, which may run before or after the deinit
+  // callbacks registered from other translation units, and those must still
+  // compute this thread's key. A new thread may so receive the index while an
+  // exiting one still uses it, which is why keys also carry the generation.
+  static int WG14_SIGNALS_PREFIX(tss_thread_index_init)(void)
+  {
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_reader_init)();
+    if(WG14_SIGNALS_PREFIX(tss_thread_index_cached) != 0)
+    {
+      return 0;
+    }
+    const uint32_t idx1 = WG14_SIGNALS_PREFIX(tss_thread_index_acquire)();
+    if(idx1 == 0)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+    void (*func)(void *) = WG14_SIGNALS_PREFIX(tss_thread_index_release);
+    if(0 != WG14_SIGNALS_PREFIX(thread_atexit)(func,
+                                               (void *) (uintptr_t) idx1))
+    {
+      WG14_SIGNALS_PREFIX(tss_thread_index_release)((void *) (uintptr_t) idx1);
+      return -1;
+    }
+    WG14_SIGNALS_PREFIX(tss_thread_index_cached) = idx1;
+    return 0;
+  }
+
+  // The current thread's map key. The generation is drawn here on first use,
+  // which is async-signal-safe; the index is only assigned by
+  // tss_thread_index_init(), so until thread_init() has run on this thread
+  // the key's low half is zero, which no entry has.
+  static uint64_t WG14_SIGNALS_PREFIX(my_current_thread_id)(void)
+  {
+    if(WG14_SIGNALS_PREFIX(tss_generation_cached) == 0)
+    {
+      // One-based: 0 is the tombstone meaning "no generation assigned yet".
+      WG14_SIGNALS_PREFIX(tss_generation_cached) =
+      (WG14_SIGNALS_PREFIX(thread_id_t))(
+      1 + atomic_fetch_add_explicit(
+          &WG14_SIGNALS_PREFIX(tss_generation_counter), 1,
+          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed));
+    }
+    // The composite key: generation in the high half, thread index in the low
+    // half.
+    return ((uint64_t) WG14_SIGNALS_PREFIX(tss_generation_cached) << 32) |
+           (uint64_t) WG14_SIGNALS_PREFIX(tss_thread_index_cached);
+  }
+
+  // Allocate a chunk of `count` inline value slots and chain all but the first
+  // onto the free list, returning the first. Call with values_lock held.
+  static void *WG14_SIGNALS_PREFIX(tss_value_chunk_add)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem,
+  struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) * chunk, size_t count)
+  {
+    // WG14_SIGNALS_MALLOC() has no alignment parameter, so the chunk was
+    // over-allocated to be aligned by hand.
+    char *slots =
+    (char *) (((uintptr_t) (chunk + 1) + mem->value_alignment - 1) &
+              ~(uintptr_t) (mem->value_alignment - 1));
+    chunk->next = mem->value_chunks;
+    mem->value_chunks = chunk;
+    for(size_t n = count - 1; n > 0; n--)
+    {
+      void *slot = slots + n * mem->value_stride;
+      WG14_SIGNALS_MEMCPY(slot, &mem->free_values, sizeof(void *));
+      mem->free_values = slot;
+    }
+    return slots;
+  }
+
+  static struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) *
+  WG14_SIGNALS_PREFIX(tss_value_chunk_new)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, size_t count)
+  {
+    return (struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) *)
+    WG14_SIGNALS_MALLOC(sizeof(struct WG14_SIGNALS_PREFIX(tss_value_chunk_t)) +
+                        mem->value_alignment - 1 + count * mem->value_stride);
+  }
+
+  // Take a zeroed inline value slot, NULL if out of memory or, for a fixed
+  // capacity instance, if every slot is in use.
+  static void *WG14_SIGNALS_PREFIX(tss_value_alloc)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem)
+  {
+    LOCK(mem->values_lock);
+    void *slot = mem->free_values;
+    if(slot != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_MEMCPY(&mem->free_values, slot, sizeof(void *));
+    }
+    UNLOCK(mem->values_lock);
+    if(slot == WG14_SIGNALS_NULLPTR && !mem->thread_id_to_tls_map.fixed)
+    {
+      // Not under the lock.
+      struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) *chunk =
+      WG14_SIGNALS_PREFIX(tss_value_chunk_new)(mem,
+                                               WG14_SIGNALS_TSS_VALUE_CHUNK);
+      if(chunk != WG14_SIGNALS_NULLPTR)
+      {
+        LOCK(mem->values_lock);
+        slot = WG14_SIGNALS_PREFIX(tss_value_chunk_add)(
+        mem, chunk, WG14_SIGNALS_TSS_VALUE_CHUNK);
+        UNLOCK(mem->values_lock);
+      }
+    }
+    if(slot != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_MEMSET(slot, 0, mem->value_stride);
+    }
+    return slot;
+  }
+
+  static void WG14_SIGNALS_PREFIX(tss_value_chunks_free)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem)
   {
-#ifdef __cplusplus
-    std::
-#endif
-    atomic_uint count;
-    WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val;
-  };
-  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s)
+    while(mem->value_chunks != WG14_SIGNALS_NULLPTR)
+    {
+      struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) *next =
+      mem->value_chunks->next;
+      WG14_SIGNALS_FREE(mem->value_chunks);
+      mem->value_chunks = next;
+    }
+  }
+
+  static void WG14_SIGNALS_PREFIX(tss_value_free)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, void *slot)
   {
-    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) attr;
+    LOCK(mem->values_lock);
+    WG14_SIGNALS_MEMCPY(slot, &mem->free_values, sizeof(void *));
+    mem->free_values = slot;
+    UNLOCK(mem->values_lock);
+  }
 
-#ifdef __cplusplus
-    std::
-#endif
-    atomic_uint lock;
-    struct WG14_SIGNALS_PREFIX(deinit_state) * state;
-    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) thread_id_to_tls_map;
-  };
+  // Make this thread's value: the user's create callback, or for inline values
+  // an inline slot which the optional create callback initialises in place.
+  static int WG14_SIGNALS_PREFIX(tss_value_create)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, void **dest)
+  {
+    if(mem->attr.value_size == 0)
+    {
+      return mem->attr.create(dest);
+    }
+    void *slot = WG14_SIGNALS_PREFIX(tss_value_alloc)(mem);
+    if(slot == WG14_SIGNALS_NULLPTR)
+    {
+      errno = ENOMEM;
+      return -1;
+    }
+    *dest = slot;
+    if(mem->attr.create != WG14_SIGNALS_NULLPTR)
+    {
+      const int ret = mem->attr.create(dest);
+      if(ret != 0)
+      {
+        WG14_SIGNALS_PREFIX(tss_value_free)(mem, slot);
+        return ret;
+      }
+    }
+    // The callback initialises the slot, it does not replace it.
+    *dest = slot;
+    return 0;
+  }
 
-  // Per-thread generation counter shared across all translation units (weak /
-  // selectany so the linker merges the per-TU definitions of a header-only
-  // build): the first library use on a thread draws a fresh generation from the
-  // process-wide counter below, so a kernel thread id reused after a thread
-  // exited without running its exit-time deinit still yields a map key no
-  // previous incarnation used (plans/analysis.md TIDR). The kernel tid cache
-  // below stays per-TU (it holds the kernel tid, which is the same value in
-  // every TU); the generation cache must be shared, or two translation units
-  // would hand the same generation to two different threads whose tids collide.
-  // Async-safe TLS where the platform provides it (Linux/Windows), plain
-  // _Thread_local elsewhere (Apple fallback): the generation is assigned from
-  // outside the signal handler, so a handler-context read of an already-primed
-  // cache is the same fast path the kernel tid cache already relies on
-  // (plans/analysis.md 7.3/AA8).
-#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
-  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
-#endif
-#if WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL
-  WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
-#else
-WG14_SIGNALS_THREAD_LOCAL
-#endif
-  WG14_SIGNALS_PREFIX(thread_id_t)
-  WG14_SIGNALS_PREFIX(tss_generation_cached) = 0;
+  static int WG14_SIGNALS_PREFIX(tss_value_destroy)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, void *v)
+  {
+    const int ret = (mem->attr.destroy != WG14_SIGNALS_NULLPTR)
+                    ? mem->attr.destroy(v)
+                    : 0;
+    if(mem->attr.value_size != 0)
+    {
+      WG14_SIGNALS_PREFIX(tss_value_free)(mem, v);
+    }
+    return ret;
+  }
 
-  // A single shared definition of the process-wide generation counter for all
-  // translation units (weak / selectany so the linker merges the per-TU
-  // definitions of a header-only multi-TU build): every thread's first library
-  // use draws on the same monotonic counter, so two threads can never share a
-  // generation. The `{0}` / `0` split is because C++ `std::atomic` rejects
-  // copy-initialisation from a scalar while C rejects brace-initialisation of
-  // `_Atomic` scalars.
-#if WG14_SIGNALS_ENABLE_HEADER_ONLY || defined(_WIN32)
-  WG14_SIGNALS_IGNORE_MULTIPLE_DEFINITIONS
-#endif
-  WG14_SIGNALS_ATOMIC_PREFIX
-  atomic_uintptr_t WG14_SIGNALS_PREFIX(tss_generation_counter) =
-#ifdef __cplusplus
-  {0};
+  // How many values a per-CPU instance has: one more than the highest CPU
+  // number the system could ever bring online, so that every CPU has a value
+  // of its own even where the numbering has gaps, or just one where the
+  // current CPU cannot be found.
+  static size_t WG14_SIGNALS_PREFIX(tss_cpu_count)(void)
+  {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (si.dwNumberOfProcessors > 0) ? (size_t) si.dwNumberOfProcessors
+                                         : 1;
+#elif defined(__linux__)
+    // A list of ranges such as "0-7,16-23", which includes CPUs not yet
+    // plugged in, unlike _SC_NPROCESSORS_CONF which counts those present
+    // and so is too small where the numbering has gaps.
+    const int fd = open("/sys/devices/system/cpu/possible", O_RDONLY);
+    if(fd != -1)
+    {
+      char buffer[256];
+      const ssize_t bytes = read(fd, buffer, sizeof(buffer));
+      (void) close(fd);
+      size_t highest = 0, number = 0;
+      bool digits = false;
+      for(ssize_t n = 0; n < bytes; n++)
+      {
+        if(buffer[n] >= '0' && buffer[n] <= '9')
+        {
+          number = number * 10 + (size_t) (buffer[n] - '0');
+          digits = true;
+          continue;
+        }
+        if(digits && number > highest)
+        {
+          highest = number;
+        }
+        number = 0;
+        digits = false;
+      }
+      if(digits && number > highest)
+      {
+        highest = number;
+      }
+      // A read which filled the buffer may have cut the list short.
+      if(bytes > 0 && (size_t) bytes < sizeof(buffer))
+      {
+        return highest + 1;
+      }
+    }
+    const long ret = sysconf(_SC_NPROCESSORS_CONF);
+    return (ret > 0) ? (size_t) ret : 1;
+#elif defined(__FreeBSD__) && __FreeBSD_version >= 1300000
+    int maxid = 0;
+    size_t len = sizeof(maxid);
+    if(0 == sysctlbyname("kern.smp.maxid", &maxid, &len, WG14_SIGNALS_NULLPTR,
+                         0) &&
+       maxid >= 0)
+    {
+      return (size_t) maxid + 1;
+    }
+    const long ret = sysconf(_SC_NPROCESSORS_CONF);
+    return (ret > 0) ? (size_t) ret : 1;
 #else
-0;
+    return 1;
 #endif
+  }
 
-  // Keep a local cache of the current thread id. Use the async-signal-safe
-  // TLS attribute where the platform provides it (Linux/Windows: initial-exec
-  // ELF TLS or MSVC TLS, both async-signal-safe with no __tls_get_addr trap on
-  // first access); on platforms without it (Apple fallback) fall back to plain
-  // _Thread_local, where the cache is primed from outside the signal handler
-  // so the first handler-context access is the fast path (analysis.md 7.3/AA8).
-  static uint64_t WG14_SIGNALS_PREFIX(my_current_thread_id)(void)
+  // The CPU this thread is running on, which it may have left by the time the
+  // caller looks. Async-signal-safe: a read of the kernel maintained
+  // restartable sequence area where there is one, else a syscall.
+  static size_t WG14_SIGNALS_PREFIX(tss_current_cpu)(void)
   {
-#ifdef WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL
-    static WG14_SIGNALS_ASYNC_SAFE_THREAD_LOCAL WG14_SIGNALS_PREFIX(thread_id_t)
-    current_thread_id_mycache;
-#else
-  static WG14_SIGNALS_THREAD_LOCAL WG14_SIGNALS_PREFIX(thread_id_t)
-  current_thread_id_mycache;
+#ifdef _WIN32
+    return (size_t) GetCurrentProcessorNumber();
+#elif defined(__linux__)
+#if WG14_SIGNALS_HAVE_RSEQ
+    // Zero if the C library did not register the area, e.g. as disabled by
+    // the glibc.pthread.rseq tunable.
+    if(__rseq_size != 0)
+    {
+      const struct rseq *area =
+      (const struct rseq *) ((const char *) __builtin_thread_pointer() +
+                             __rseq_offset);
+      // Negative until the kernel has first filled it in.
+      const int32_t cpu = (int32_t) * (volatile const uint32_t *) &area->cpu_id;
+      if(cpu >= 0)
+      {
+        return (size_t) cpu;
+      }
+    }
 #endif
-    if(current_thread_id_mycache == WG14_SIGNALS_PREFIX(thread_id_t_tombstone))
+    unsigned cpu = 0;
+    if(0 != WG14_SIGNALS_GETCPU(&cpu))
     {
-      current_thread_id_mycache = WG14_SIGNALS_PREFIX(current_thread_id)();
+      return 0;
     }
-    if(WG14_SIGNALS_PREFIX(tss_generation_cached) == 0)
+    return cpu;
+#elif defined(__FreeBSD__) && __FreeBSD_version >= 1300000
+    // A read of the CPU number the kernel keeps in user memory, or the
+    // instruction which finds it, so also safe to call from a handler.
+    const int cpu = sched_getcpu();
+    return (cpu >= 0) ? (size_t) cpu : 0;
+#else
+    return 0;
+#endif
+  }
+
+  // Destroy the first `count` of a per-CPU instance's values.
+  static void WG14_SIGNALS_PREFIX(tss_cpu_values_destroy)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, size_t count)
+  {
+    while(count > 0)
     {
-      // One-based: 0 is the tombstone meaning "no generation assigned yet".
-      WG14_SIGNALS_PREFIX(tss_generation_cached) =
-      (WG14_SIGNALS_PREFIX(thread_id_t))(
-      1 + atomic_fetch_add_explicit(
-          &WG14_SIGNALS_PREFIX(tss_generation_counter), 1,
-          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed));
+      (void) WG14_SIGNALS_PREFIX(tss_value_destroy)(mem,
+                                                    mem->cpu_values[--count]);
     }
-    // The composite key: generation in the high half, kernel thread id in the
-    // low half. Two threads always differ in generation, so the low-half
-    // truncation cannot alias distinct tids with distinct generations.
-    return ((uint64_t) WG14_SIGNALS_PREFIX(tss_generation_cached) << 32) |
-           (uint64_t) (uint32_t) current_thread_id_mycache;
+    WG14_SIGNALS_FREE(mem->cpu_values);
+    mem->cpu_values = WG14_SIGNALS_NULLPTR;
   }
 
   int WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(
@@ -172,8 +1532,115 @@ WG14_SIGNALS_THREAD_LOCAL
       return -1;
     }
     WG14_SIGNALS_MEMCPY(&mem->attr, attr, sizeof(mem->attr));
-    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_init)
-    (&mem->thread_id_to_tls_map);
+    if(attr->value_size != 0)
+    {
+      mem->value_alignment = WG14_SIGNALS_TSS_VALUE_ALIGNMENT;
+      while(mem->value_alignment < attr->value_alignment)
+      {
+        mem->value_alignment *= 2;
+      }
+      // Room for the free list link too.
+      mem->value_stride =
+      (((attr->value_size < sizeof(void *)) ? sizeof(void *)
+                                            : attr->value_size) +
+       mem->value_alignment - 1) &
+      ~(mem->value_alignment - 1);
+    }
+    mem->serial = 1 + atomic_fetch_add_explicit(
+                      &WG14_SIGNALS_PREFIX(tss_serial_counter), 1,
+                      WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    mem->state =
+    (struct WG14_SIGNALS_PREFIX(deinit_state) *) WG14_SIGNALS_CALLOC(
+    1, sizeof(struct WG14_SIGNALS_PREFIX(deinit_state)));
+    if(mem->state == WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_FREE(mem);
+      errno = ENOMEM;
+      return -1;
+    }
+    mem->state->val = mem;
+    atomic_store_explicit(&mem->state->count, 1u,
+                          WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    if(!WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_init)(
+       &mem->thread_id_to_tls_map, attr->max_threads))
+    {
+      WG14_SIGNALS_FREE(mem->state);
+      WG14_SIGNALS_FREE(mem);
+      errno = ENOMEM;
+      return -1;
+    }
+    if(attr->per_cpu)
+    {
+      mem->ncpus = WG14_SIGNALS_PREFIX(tss_cpu_count)();
+    }
+    // The values a per-CPU instance will ever have, or the most a fixed
+    // capacity one will have at once.
+    const size_t prealloc = attr->per_cpu ? mem->ncpus : attr->max_threads;
+    if(attr->value_size != 0 && prealloc != 0)
+    {
+      struct WG14_SIGNALS_PREFIX(tss_value_chunk_t) *chunk =
+      WG14_SIGNALS_PREFIX(tss_value_chunk_new)(mem, prealloc);
+      if(chunk == WG14_SIGNALS_NULLPTR)
+      {
+        WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_cleanup)
+        (&mem->thread_id_to_tls_map);
+        WG14_SIGNALS_FREE(mem->state);
+        WG14_SIGNALS_FREE(mem);
+        errno = ENOMEM;
+        return -1;
+      }
+      // Onto the free list with the rest.
+      WG14_SIGNALS_PREFIX(tss_value_free)(
+      mem, WG14_SIGNALS_PREFIX(tss_value_chunk_add)(mem, chunk, prealloc));
+    }
+    if(attr->per_cpu)
+    {
+      mem->cpu_values =
+      (void **) WG14_SIGNALS_CALLOC(mem->ncpus, sizeof(void *));
+      int ret = 0;
+      size_t n = 0;
+      if(mem->cpu_values == WG14_SIGNALS_NULLPTR)
+      {
+        errno = ENOMEM;
+        ret = -1;
+      }
+      while(ret == 0 && n < mem->ncpus)
+      {
+        ret = WG14_SIGNALS_PREFIX(tss_value_create)(mem, &mem->cpu_values[n]);
+        if(ret == 0 && mem->cpu_values[n] == WG14_SIGNALS_NULLPTR)
+        {
+          // As for a thread's value in tss_thread_register().
+          errno = EINVAL;
+          ret = -1;
+        }
+        if(ret == 0)
+        {
+          n++;
+        }
+      }
+      if(ret != 0)
+      {
+        if(mem->cpu_values != WG14_SIGNALS_NULLPTR)
+        {
+          WG14_SIGNALS_PREFIX(tss_cpu_values_destroy)(mem, n);
+        }
+        WG14_SIGNALS_PREFIX(tss_value_chunks_free)(mem);
+        WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_cleanup)
+        (&mem->thread_id_to_tls_map);
+        WG14_SIGNALS_FREE(mem->state);
+        WG14_SIGNALS_FREE(mem);
+        return ret;
+      }
+    }
+    LOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+    mem->instances_next = WG14_SIGNALS_PREFIX(tss_instances);
+    if(mem->instances_next != WG14_SIGNALS_NULLPTR)
+    {
+      mem->instances_next->instances_prev = mem;
+    }
+    WG14_SIGNALS_PREFIX(tss_instances) = mem;
+    WG14_SIGNALS_PREFIX(tss_instances_count)++;
+    UNLOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
     *val = mem;
     return 0;
   }
@@ -183,37 +1650,54 @@ WG14_SIGNALS_THREAD_LOCAL
   {
     struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
     (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
-    LOCK(mem->lock);
-    if(mem->state)
+    LOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+    if(mem->instances_prev != WG14_SIGNALS_NULLPTR)
+    {
+      mem->instances_prev->instances_next = mem->instances_next;
+    }
+    else
+    {
+      WG14_SIGNALS_PREFIX(tss_instances) = mem->instances_next;
+    }
+    if(mem->instances_next != WG14_SIGNALS_NULLPTR)
+    {
+      mem->instances_next->instances_prev = mem->instances_prev;
+    }
+    WG14_SIGNALS_PREFIX(tss_instances_count)--;
+    UNLOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+    // Other threads' slots for this instance are never matched again, as no
+    // later instance takes its serial; this thread's must go now, so that a
+    // re-entrant get() from a destroy callback below misses.
+    WG14_SIGNALS_PREFIX(tss_cache_forget)(mem->serial);
+    // Threads still registered find the instance gone when they exit.
+    struct WG14_SIGNALS_PREFIX(deinit_state) *state = mem->state;
+    state->val = WG14_SIGNALS_NULLPTR;
+    if(1 == atomic_fetch_sub_explicit(
+            &state->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel))
     {
-      mem->state->val = WG14_SIGNALS_NULLPTR;
-      mem->state = WG14_SIGNALS_NULLPTR;
+      WG14_SIGNALS_FREE(state);
     }
-    // The user's attr.destroy callback must not run while mem->lock is held: a
-    // documented-valid re-entrant call from the callback -- e.g.
+    // The user's attr.destroy callback may re-enter the library -- e.g.
     // tss_async_signal_safe_get() on the same handle, documented THREADSAFE
-    // ASYNC-SIGNAL-SAFE -- would self-deadlock on the non-recursive spinlock
-    // (plans/analysis.md UCLK, SPIN). Each value is therefore erased from the
-    // map under the lock first -- so a re-entrant get() can never observe a
-    // value whose destroy callback is running or has run -- and its callback is
-    // invoked after the lock is released, mirroring
-    // tss_async_signal_safe_thread_deinit. erase_itr() returns the next
-    // iterator, the verstable-supported pattern for erasing while iterating.
-    for(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_itr)
-        it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_first)(
-        &mem->thread_id_to_tls_map);
-        !WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it);)
-    {
-      void *item = it.data->val;
-      it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase_itr)(
-      &mem->thread_id_to_tls_map, it);
-      UNLOCK(mem->lock);
-      mem->attr.destroy(item);
-      LOCK(mem->lock);
+    // ASYNC-SIGNAL-SAFE (plans/analysis.md UCLK). Each value is therefore
+    // erased from the map before its callback is invoked, so a re-entrant get()
+    // can never observe a value whose destroy callback is running or has run.
+    size_t pos = 0;
+    for(void *item = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase_next)(
+        &mem->thread_id_to_tls_map, &pos);
+        item != WG14_SIGNALS_NULLPTR;
+        item = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase_next)(
+        &mem->thread_id_to_tls_map, &pos))
+    {
+      (void) WG14_SIGNALS_PREFIX(tss_value_destroy)(mem, item);
+    }
+    if(mem->cpu_values != WG14_SIGNALS_NULLPTR)
+    {
+      WG14_SIGNALS_PREFIX(tss_cpu_values_destroy)(mem, mem->ncpus);
     }
     WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_cleanup)
     (&mem->thread_id_to_tls_map);
-    UNLOCK(mem->lock);
+    WG14_SIGNALS_PREFIX(tss_value_chunks_free)(mem);
     WG14_SIGNALS_FREE(mem);
     return 0;
   }
@@ -226,122 +1710,228 @@ WG14_SIGNALS_THREAD_LOCAL
     int ret = 0;
     if(mem != WG14_SIGNALS_NULLPTR)
     {
-      const uint64_t mytid = WG14_SIGNALS_PREFIX(my_current_thread_id)();
-      LOCK(mem->lock);
-      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_itr)
-      it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
-      &mem->thread_id_to_tls_map, mytid);
-      if(!WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it))
-      {
-        void *item = it.data->val;
-        UNLOCK(mem->lock);
-        ret = mem->attr.destroy(item);
-        LOCK(mem->lock);
-        WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)
-        (&mem->thread_id_to_tls_map, mytid);
-      }
-      // The count decrement and the state free must both hold mem->lock, or
-      // two threads exiting concurrently could free state while the other
-      // thread is still decrementing it (or reading state->val), and a later
-      // thread_init/destroy would see a dangling mem->state. Only the last
-      // registered thread frees state, and it must clear mem->state first so
-      // that no later thread_init or destroy writes through the freed pointer.
-      if(1 ==
-         atomic_fetch_sub_explicit(
-         &state->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
-      {
-        if(state == mem->state)
+      // Erased first so that no for_each() starting from now can visit it.
+      // The slot cache keeps serving get() on this thread, including to the
+      // destroy callback, until the value is gone.
+      void *item = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)(
+      &mem->thread_id_to_tls_map, WG14_SIGNALS_PREFIX(my_current_thread_id)());
+      if(item != WG14_SIGNALS_NULLPTR)
+      {
+        // Then wait out the visits which may have read it already: those
+        // which took visits_lock before this does, as a later one sees the
+        // erase. Visits starting meanwhile do not prolong the wait.
+        LOCK(mem->visits_lock);
+        const uintptr_t erased = mem->visit_epoch++;
+        UNLOCK(mem->visits_lock);
+        for(bool older = true; older;)
         {
-          mem->state = WG14_SIGNALS_NULLPTR;
+          older = false;
+          LOCK(mem->visits_lock);
+          for(const struct WG14_SIGNALS_PREFIX(tss_visit_t) *v = mem->visits;
+              v != WG14_SIGNALS_NULLPTR && !older; v = v->next)
+          {
+            older = (v->epoch <= erased);
+          }
+          UNLOCK(mem->visits_lock);
+          if(older)
+          {
+            WG14_SIGNALS_CPU_RELAX();
+          }
         }
-        WG14_SIGNALS_FREE(state);
+        ret = WG14_SIGNALS_PREFIX(tss_value_destroy)(mem, item);
       }
-      UNLOCK(mem->lock);
+      WG14_SIGNALS_PREFIX(tss_cache_forget)(mem->serial);
     }
-    else
+    // The last reference frees state: while the instance lives, that is its
+    // own, so only a thread still registered when the instance was destroyed
+    // can be last.
+    if(1 == atomic_fetch_sub_explicit(
+            &state->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acq_rel))
     {
-      // The instance was destroyed while this thread was still registered:
-      // destroy() dropped its own pointer and cleared state->val but did not
-      // free the deinit_state, so the reference this thread took at
-      // thread_init() is still outstanding. Drop it now; the last registered
-      // thread frees state.
-      if(1 ==
-         atomic_fetch_sub_explicit(
-         &state->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed))
-      {
-        WG14_SIGNALS_FREE(state);
-      }
+      WG14_SIGNALS_FREE(state);
     }
     return ret;
   }
 
+  // Register the current thread, whose key is `mytid`, with the instance. On
+  // success *state is the state to pass to thread_deinit() at thread exit, or
+  // NULL if the thread was registered already.
+  static int WG14_SIGNALS_PREFIX(tss_thread_register)(
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) * mem, uint64_t mytid,
+  struct WG14_SIGNALS_PREFIX(deinit_state) * *state)
+  {
+    *state = WG14_SIGNALS_NULLPTR;
+    if(mem->cpu_values != WG14_SIGNALS_NULLPTR)
+    {
+      // A per-CPU instance's values already exist.
+      return 0;
+    }
+    void *item = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
+    &mem->thread_id_to_tls_map, mytid);
+    if(item != WG14_SIGNALS_NULLPTR)
+    {
+      // The slot may have been evicted by other instances since.
+      WG14_SIGNALS_PREFIX(tss_cache_store)(mem->serial, item);
+      return 0;
+    }
+    // Only this thread inserts its own key, so nothing can insert it between
+    // the lookup above and the insert below.
+    void *newitem = WG14_SIGNALS_NULLPTR;
+    int ret = WG14_SIGNALS_PREFIX(tss_value_create)(mem, &newitem);
+    if(ret != 0)
+    {
+      // The create callback reported failure; propagate its error code.
+      return ret;
+    }
+    if(newitem == WG14_SIGNALS_NULLPTR)
+    {
+      // A create callback that returns 0 but leaves *dest NULL is broken: it
+      // would otherwise report success while no TID is inserted into the map,
+      // and a later get() on this thread would return NULL indistinguishably
+      // (plans/analysis.md 2.5). Report failure explicitly.
+      errno = EINVAL;
+      return -1;
+    }
+    // A fixed capacity instance which is full fails here too.
+    if(!WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
+       &mem->thread_id_to_tls_map, mytid, newitem))
+    {
+      (void) WG14_SIGNALS_PREFIX(tss_value_destroy)(mem, newitem);
+      errno = ENOMEM;
+      return -1;
+    }
+    atomic_fetch_add_explicit(&mem->state->count, 1,
+                              WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    WG14_SIGNALS_PREFIX(tss_cache_store)(mem->serial, newitem);
+    *state = mem->state;
+    return 0;
+  }
+
   int WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(
   WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val)
   {
     struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
     (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
     // This will force init the TLS from outside a signal handle
+    if(0 != WG14_SIGNALS_PREFIX(tss_thread_index_init)())
+    {
+      return -1;
+    }
+    struct WG14_SIGNALS_PREFIX(deinit_state) *state = WG14_SIGNALS_NULLPTR;
+    const int ret = WG14_SIGNALS_PREFIX(tss_thread_register)(
+    mem, WG14_SIGNALS_PREFIX(my_current_thread_id)(), &state);
+    if(ret != 0 || state == WG14_SIGNALS_NULLPTR)
+    {
+      return ret;
+    }
+    void (*func)(void *) = (void (*)(void *))(uintptr_t) WG14_SIGNALS_PREFIX(
+    tss_async_signal_safe_thread_deinit);
+    return WG14_SIGNALS_PREFIX(thread_atexit)(func, state);
+  }
+
+  // The states a thread_init_many() call registered the thread with, all
+  // deinitialised by one exit-time callback. The states follow the count.
+  struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t)
+  {
+    size_t count;
+  };
+
+  static inline struct WG14_SIGNALS_PREFIX(deinit_state) **
+  WG14_SIGNALS_PREFIX(tss_deinit_batch_states)(
+  struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t) * batch)
+  {
+    return (struct WG14_SIGNALS_PREFIX(deinit_state) **) (batch + 1);
+  }
+
+  static void WG14_SIGNALS_PREFIX(tss_deinit_batch)(void *p)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t) *batch =
+    (struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t) *) p;
+    struct WG14_SIGNALS_PREFIX(deinit_state) **states =
+    WG14_SIGNALS_PREFIX(tss_deinit_batch_states)(batch);
+    // In reverse, as separate registrations would have run.
+    while(batch->count > 0)
+    {
+      (void) WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_deinit)(
+      states[--batch->count]);
+    }
+    WG14_SIGNALS_FREE(batch);
+  }
+
+  int WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_many)(
+  const WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) * vals, size_t count)
+  {
+    if(0 != WG14_SIGNALS_PREFIX(tss_thread_index_init)())
+    {
+      return -1;
+    }
     const uint64_t mytid = WG14_SIGNALS_PREFIX(my_current_thread_id)();
-    LOCK(mem->lock);
-    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
-    &mem->thread_id_to_tls_map, mytid);
-    int res = 0;
-    if(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it))
+    struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t) *batch =
+    WG14_SIGNALS_NULLPTR;
+    for(size_t n = 0; n < count; n++)
     {
-      UNLOCK(mem->lock);
-      void *newitem = WG14_SIGNALS_NULLPTR;
-      int ret = mem->attr.create(&newitem);
+      struct WG14_SIGNALS_PREFIX(deinit_state) *state = WG14_SIGNALS_NULLPTR;
+      const int ret = WG14_SIGNALS_PREFIX(tss_thread_register)(
+      (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) vals[n], mytid,
+      &state);
       if(ret != 0)
       {
-        // The create callback reported failure; propagate its error code.
+        // Those before it stay registered, and are deinitialised at exit.
         return ret;
       }
-      if(newitem == WG14_SIGNALS_NULLPTR)
+      if(state == WG14_SIGNALS_NULLPTR)
       {
-        // A create callback that returns 0 but leaves *dest NULL is broken: it
-        // would otherwise report success while no TID is inserted into the map,
-        // and a later get() on this thread would return NULL indistinguishably
-        // (plans/analysis.md 2.5). Report failure explicitly.
-        errno = EINVAL;
-        return -1;
-      }
-      LOCK(mem->lock);
-      it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
-      &mem->thread_id_to_tls_map, mytid, newitem);
-      if(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it))
-      {
-        UNLOCK(mem->lock);
-        mem->attr.destroy(newitem);
-        errno = ENOMEM;
-        return -1;
+        continue;
       }
-      if(mem->state == WG14_SIGNALS_NULLPTR)
+      if(batch == WG14_SIGNALS_NULLPTR)
       {
-        mem->state =
-        (struct WG14_SIGNALS_PREFIX(deinit_state) *) WG14_SIGNALS_CALLOC(
-        1, sizeof(struct WG14_SIGNALS_PREFIX(deinit_state)));
-        if(mem->state == WG14_SIGNALS_NULLPTR)
+        // Room for this and every instance after it.
+        batch = (struct WG14_SIGNALS_PREFIX(tss_deinit_batch_t) *)
+        WG14_SIGNALS_CALLOC(1, sizeof(*batch) + (count - n) * sizeof(state));
+        void (*func)(void *) = WG14_SIGNALS_PREFIX(tss_deinit_batch);
+        if(batch == WG14_SIGNALS_NULLPTR ||
+           0 != WG14_SIGNALS_PREFIX(thread_atexit)(func, batch))
         {
-          WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)
-          (&mem->thread_id_to_tls_map, mytid);
-          UNLOCK(mem->lock);
-          mem->attr.destroy(newitem);
+          (void) WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_deinit)(
+          state);
+          WG14_SIGNALS_FREE(batch);
           errno = ENOMEM;
           return -1;
         }
-        mem->state->val = val;
       }
-      atomic_fetch_add_explicit(
-      &mem->state->count, 1, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
-      UNLOCK(mem->lock);
-      void (*func)(void *) = (void (*)(void *))(uintptr_t) WG14_SIGNALS_PREFIX(
-      tss_async_signal_safe_thread_deinit);
-      res = WG14_SIGNALS_PREFIX(thread_atexit)(func, mem->state);
-      return res;
+      WG14_SIGNALS_PREFIX(tss_deinit_batch_states)(batch)[batch->count++] =
+      state;
+    }
+    return 0;
+  }
+
+  int WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_all)(void)
+  {
+    LOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+    const size_t count = WG14_SIGNALS_PREFIX(tss_instances_count);
+    WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) *vals =
+    (WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) *) WG14_SIGNALS_MALLOC(
+    (count + 1) * sizeof(*vals));
+    if(vals == WG14_SIGNALS_NULLPTR)
+    {
+      UNLOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+      errno = ENOMEM;
+      return -1;
+    }
+    // Oldest first, as the list is newest first.
+    size_t n = count;
+    for(struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
+        WG14_SIGNALS_PREFIX(tss_instances);
+        mem != WG14_SIGNALS_NULLPTR; mem = mem->instances_next)
+    {
+      vals[--n] = mem;
     }
-    UNLOCK(mem->lock);
-    return res;
+    UNLOCK(WG14_SIGNALS_PREFIX(tss_instances_lock));
+    // Not under the lock, as the create callbacks may create instances.
+    const int ret =
+    WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_many)(vals, count);
+    WG14_SIGNALS_FREE(vals);
+    return ret;
   }
 
   void *WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(
@@ -349,20 +1939,131 @@ WG14_SIGNALS_THREAD_LOCAL
   {
     struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
     (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
-    const uint64_t mytid = WG14_SIGNALS_PREFIX(my_current_thread_id)();
-    void *ret = WG14_SIGNALS_NULLPTR;
-    LOCK(mem->lock);
-    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_itr)
-    it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
-    &mem->thread_id_to_tls_map, mytid);
-    if(!WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it))
+    if(mem->cpu_values != WG14_SIGNALS_NULLPTR)
+    {
+      // Every CPU which could ever come online has its own value, so the
+      // modulo only guards against a kernel reporting a number it did not
+      // declare possible.
+      const size_t cpu = WG14_SIGNALS_PREFIX(tss_current_cpu)();
+      return mem->cpu_values[(cpu < mem->ncpus) ? cpu : cpu % mem->ncpus];
+    }
+    const struct WG14_SIGNALS_PREFIX(tss_cache_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(tss_cache_slots);
+    for(size_t n = 0; n < WG14_SIGNALS_TSS_CACHE_SLOTS; n++)
+    {
+      if(slots[n].serial == mem->serial)
+      {
+        return slots[n].value;
+      }
+    }
+    // Not initialised on this thread, or evicted by other instances.
+    return WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)(
+    &mem->thread_id_to_tls_map, WG14_SIGNALS_PREFIX(my_current_thread_id)());
+  }
+
+  int WG14_SIGNALS_PREFIX(tss_async_signal_safe_for_each)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val,
+  int (*func)(void *value, void *arg), void *arg)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
+    (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
+    if(mem->cpu_values != WG14_SIGNALS_NULLPTR)
+    {
+      // These live until the instance is destroyed.
+      int ret = 0;
+      for(size_t n = 0; ret == 0 && n < mem->ncpus; n++)
+      {
+        ret = func(mem->cpu_values[n], arg);
+      }
+      return ret;
+    }
+    struct WG14_SIGNALS_PREFIX(tss_visit_t) visit;
+    LOCK(mem->visits_lock);
+    visit.epoch = mem->visit_epoch;
+    visit.prev = WG14_SIGNALS_NULLPTR;
+    visit.next = mem->visits;
+    if(visit.next != WG14_SIGNALS_NULLPTR)
+    {
+      visit.next->prev = &visit;
+    }
+    mem->visits = &visit;
+    UNLOCK(mem->visits_lock);
+    // A table superseded during the visit is kept, unchanged, until it ends,
+    // so it can still be scanned. It misses only what was registered after it
+    // was frozen.
+    bool announced;
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(&mem->thread_id_to_tls_map,
+                                                  &announced);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *slots =
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table);
+    int ret = 0;
+    for(size_t n = 0; ret == 0 && n <= table->mask; n++)
+    {
+      // Zero while the slot is empty, or its insert is still in progress.
+      void *item = (void *) atomic_load_explicit(
+      &slots[n].val, WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+      if(item != WG14_SIGNALS_NULLPTR)
+      {
+        ret = func(item, arg);
+      }
+    }
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    LOCK(mem->visits_lock);
+    if(visit.prev != WG14_SIGNALS_NULLPTR)
+    {
+      visit.prev->next = visit.next;
+    }
+    else
+    {
+      mem->visits = visit.next;
+    }
+    if(visit.next != WG14_SIGNALS_NULLPTR)
     {
-      ret = it.data->val;
+      visit.next->prev = visit.prev;
     }
-    UNLOCK(mem->lock);
+    UNLOCK(mem->visits_lock);
     return ret;
   }
 
+  int WG14_SIGNALS_PREFIX(tss_async_signal_safe_compact)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
+    (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_compact)
+    (&mem->thread_id_to_tls_map);
+    return 0;
+  }
+
+  void WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val,
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats_t) * stats)
+  {
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
+    (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) val;
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t) *map =
+    &mem->thread_id_to_tls_map;
+    // The lock keeps the chain of tables, and the counters, still.
+    LOCK(map->grow_lock);
+    struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load_explicit(&map->table,
+                         WG14_SIGNALS_ATOMIC_PREFIX memory_order_acquire);
+    stats->threads = atomic_load_explicit(
+    &table->count, WG14_SIGNALS_ATOMIC_PREFIX memory_order_relaxed);
+    stats->capacity = table->mask + 1;
+    stats->bytes = 0;
+    for(; table != WG14_SIGNALS_NULLPTR; table = table->prev)
+    {
+      stats->bytes +=
+      WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_bytes)(table);
+    }
+    stats->shrinks = map->shrinks;
+    stats->bytes_saved = map->bytes_saved;
+    UNLOCK(map->grow_lock);
+  }
+
 #ifdef __cplusplus
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic pop
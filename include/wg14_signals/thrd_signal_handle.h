@@ -467,6 +467,7 @@ typedef ucontext_t WG14_SIGNALS_PREFIX(stdc_siginfo_context_t);
   struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_per_frame_t);
   struct WG14_SIGNALS_PREFIX(sighandler_info);
   struct WG14_SIGNALS_PREFIX(global_signal_decider_t);
+  struct WG14_SIGNALS_PREFIX(sig_reader_t);
 
   /*! \struct stdc_siginfo
   \brief A platform independent subset of `siginfo_t`.
@@ -503,6 +504,9 @@ typedef ucontext_t WG14_SIGNALS_PREFIX(stdc_siginfo_context_t);
     void *internal_win_state;
 #endif
     bool internal_decider_is_abandoned;
+    struct WG14_SIGNALS_PREFIX(sig_reader_t) * internal_reader;
+    uintptr_t internal_global_decider_id;
+    unsigned char internal_global_reader;
   };
 
   //! \brief The type of the guarded function.
@@ -601,10 +605,14 @@ typedef ucontext_t WG14_SIGNALS_PREFIX(stdc_siginfo_context_t);
   \return The value returned by `guarded`, or `recovery`. If the per-thread
   state required by this facility cannot be set up, `SIGGUARDED_FAILURE_VALUE`
   is returned.
-  \param signals The set of signals to guard against.
+  \param signals The set of signals to guard against. It must not be changed
+  until the guard returns, as it may be read only on entry.
   \param guarded A function whose execution is to be guarded against signal
   raises.
-  \param recovery A function to be called if a signal is raised.
+  \param recovery A function to be called if a signal is raised. May be null,
+  when a decider asking for recovery passes the signal on to the outer
+  guards instead; an "observe and resume" guard which cannot recover is
+  cheaper, as on POSIX it then saves no context to return to.
   \param decider A function to be called to decide whether to
   recover from the signal and continue the execution of the guarded routine, or
   to abort and call the recovery routine.
@@ -655,6 +663,62 @@ typedef ucontext_t WG14_SIGNALS_PREFIX(stdc_siginfo_context_t);
   WG14_SIGNALS_EXTERN void WG14_SIGNALS_PREFIX(sigdecider_abandon_resume)(
   struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi);
 
+  //! \brief A range of code whose guarded signals resume at a landing pad.
+  struct WG14_SIGNALS_PREFIX(sigguarded_region)
+  {
+    //! \brief The first byte of the region's code.
+    const void *begin;
+    //! \brief One past the last byte of the region's code.
+    const void *end;
+    //! \brief Where execution resumes instead, with the registers and stack
+    //! as they were at the interrupted instruction.
+    const void *landing_pad;
+  };
+
+  /*! \brief THREADSAFE Registers code regions guarded against `signals`
+  without any per call cost, in the style of table driven exception handling.
+
+  \return An opaque pointer to the registration, or `NULL` with `errno` set:
+  to `EINVAL` if `signals` or `regions` is null, `count` is zero, a region is
+  empty or has no landing pad, or two registered regions overlap; to `ENOTSUP`
+  where the interrupted instruction's address cannot be read from a signal's
+  context; or to `ENOMEM`.
+  \param signals The set of signals to guard against. It is copied.
+  \param regions The `count` regions to register. They are copied.
+  \param count The number of regions.
+
+  When `stdc_raise()` is given a context, as the handlers `siginstall()`
+  installs always give it, and the context's instruction address lies within
+  a registered region guarding the signal, the context is altered to resume
+  at the region's landing pad, and it returns true without consulting any
+  decider. The signal must therefore be installed for a real fault to be
+  redirected. Regions are consulted before the calling thread's
+  `sigguarded()` frames, as the interrupted instruction is innermost. Code
+  which never raises a guarded signal runs exactly as it would unguarded.
+
+  The landing pad must be able to run in the register and stack state of any
+  instruction in the region which may raise, so regions and their landing pads
+  are usually written in assembler, as with an operating system kernel's
+  exception table. For example, a region of one load instruction whose landing
+  pad sets the load's destination register to a sentinel value and jumps back
+  to the instruction after it.
+
+  ## POSIX only
+
+  On Windows this fails with `ENOTSUP`.
+  */
+  WG14_SIGNALS_EXTERN void *WG14_SIGNALS_PREFIX(sigguarded_regions_register)(
+  const sigset_t *signals,
+  const struct WG14_SIGNALS_PREFIX(sigguarded_region) * regions, size_t count);
+  /*! \brief THREADSAFE Deregister regions registered by
+  `sigguarded_regions_register()`. A raise which started before this call may
+  still resume at one of their landing pads.
+  \return 0 if successful, a negative value with `errno` set to `EINVAL` if
+  `registration` was a null pointer or is not currently registered.
+  */
+  WG14_SIGNALS_EXTERN int
+  WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(void *registration);
+
 #if defined(__clang__) && defined(__cplusplus)
 #pragma clang diagnostic pop
 #endif
@@ -778,6 +842,28 @@ typedef ucontext_t WG14_SIGNALS_PREFIX(stdc_siginfo_context_t);
   WG14_SIGNALS_EXTERN int
   WG14_SIGNALS_PREFIX(signal_decider_destroy)(void *decider);
 
+  /*! \brief Counters of the deferred reclamation behind the global signal
+  continuation deciders. Registration changes retire what a concurrent raise
+  may still be walking, and retired objects are freed once no raise can be.
+  */
+  struct WG14_SIGNALS_PREFIX(sigreclaim_stats_t)
+  {
+    size_t pending;       //!< Objects retired but not yet freed.
+    size_t pending_peak;  //!< The most objects ever pending at once.
+    size_t retired;       //!< Objects retired in total.
+    size_t reclaimed;     //!< Objects freed in total.
+    //! Registration changes which gave up waiting for in flight raises,
+    //! leaving more than `WG14_SIGNALS_RECLAIM_PENDING_LIMIT` pending.
+    size_t waits_abandoned;
+  };
+  /*! \brief THREADSAFE ASYNC-SIGNAL-SAFE Fill in the current deferred
+  reclamation counters, for monitoring memory held on behalf of in flight
+  raises. Each counter is read individually, so they may be mutually
+  inconsistent while registrations change concurrently.
+  */
+  WG14_SIGNALS_EXTERN void WG14_SIGNALS_PREFIX(sigreclaim_stats)(
+  struct WG14_SIGNALS_PREFIX(sigreclaim_stats_t) * stats);
+
 
 #ifdef __cplusplus
 }
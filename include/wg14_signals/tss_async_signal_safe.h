@@ -22,6 +22,8 @@ limitations under the License.
 
 #include "config.h"
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -34,10 +36,41 @@ extern "C"
   //! \brief The attributes for creating an async signal safe thread local
   struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
   {
-    int (*const create)(
-    void **dest);  //!< THREADSAFE REENTRANT Create an instance
-    int (*const destroy)(
-    void *v);  //!< THREADSAFE REENTRANT Destroy an instance
+    //! THREADSAFE REENTRANT Create an instance. With a nonzero `value_size`,
+    //! optional: `*dest` then points at the zeroed inline storage, which it
+    //! initialises in place.
+    int (*const create)(void **dest);
+    //! THREADSAFE REENTRANT Destroy an instance. With a nonzero `value_size`,
+    //! optional: it tears down the inline storage, which the library frees.
+    int (*const destroy)(void *v);
+    //! If nonzero, the most threads which may be registered with the instance
+    //! at once. Its lookup table, and with a nonzero `value_size` its values,
+    //! are then all allocated by `tss_async_signal_safe_create()`, so that
+    //! `tss_async_signal_safe_thread_init()` never allocates them or rehashes,
+    //! but fails with `ENOMEM` for one thread more. A thread's first use of
+    //! the library may still allocate its own bookkeeping, such as its
+    //! exit-time registration. If zero, storage grows on demand.
+    const size_t max_threads;
+    //! If nonzero, the library stores each thread's value inline, in slots of
+    //! at least this many bytes, from slabs it allocates itself. Each slot is
+    //! aligned to a cache line, so that no two threads' values share one.
+    const size_t value_size;
+    //! The alignment inline values need, a power of two. Zero, or anything up
+    //! to a cache line, gets a cache line.
+    const size_t value_alignment;
+    //! If true, there is one value per CPU rather than per thread, all made by
+    //! `tss_async_signal_safe_create()` and destroyed by
+    //! `tss_async_signal_safe_destroy()`, so storage is proportional to the
+    //! CPU count however many threads there are, and no thread need call
+    //! `tss_async_signal_safe_thread_init()` (which does nothing).
+    //! `tss_async_signal_safe_get()` returns the value of the CPU the thread
+    //! is running on, but the thread may be migrated to another CPU at any
+    //! time, and the value may meanwhile be used by another thread, or a
+    //! signal handler, on its CPU: values must be updated with atomics, e.g.
+    //! relaxed `atomic_fetch_add()` on a per-CPU counter. Where the current
+    //! CPU cannot be found, there is just one value. `max_threads` is
+    //! ignored.
+    const bool per_cpu;
   };
 
   //! \brief Create an async signal safe thread local instance
@@ -73,12 +106,83 @@ extern "C"
   WG14_SIGNALS_EXTERN int
   WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(
   WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val);
+  /*! \brief THREADSAFE Initialise many async signal safe thread local
+  instances for a specific thread
+
+  As `tss_async_signal_safe_thread_init()` on each of `count` instances in
+  turn, but with one registration for deinitialisation at thread exit rather
+  than one per instance, which then deinitialises them in reverse order. On
+  failure the instances before the one which failed stay initialised.
+  */
+  WG14_SIGNALS_EXTERN int
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_many)(
+  const WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) * vals, size_t count);
+  /*! \brief THREADSAFE Initialise every async signal safe thread local
+  instance for a specific thread
+
+  As `tss_async_signal_safe_thread_init_many()` on every instance which
+  exists, oldest first, e.g. at the start of each thread in a pool. No
+  instance may be destroyed meanwhile. Instances created meanwhile may or may
+  not be initialised.
+  */
+  WG14_SIGNALS_EXTERN int
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_all)(void);
 
   /*! \brief THREADSAFE ASYNC-SIGNAL-SAFE Get the thread local value for the
    * current thread.
    */
   WG14_SIGNALS_EXTERN void *WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(
   WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val);
+  /*! \brief THREADSAFE Call `func` with the value of every thread currently
+  registered with an async signal safe thread local instance
+
+  Other threads may keep calling `tss_async_signal_safe_get()`,
+  `tss_async_signal_safe_thread_init()` and exiting meanwhile: none of them is
+  stopped. A value is not destroyed while `func` may be visiting it, as a
+  thread exiting meanwhile waits for the visits which started before it
+  deregistered to end before destroying its value, so `func` must neither
+  block on, nor take long while, threads exit.
+  A thread registering meanwhile may or may not be visited. `func` can read
+  values other threads are still writing, so values which are visited must be
+  written with atomics, e.g. per-thread counters aggregated by a metrics
+  thread. Not async signal safe, and the instance must not be destroyed
+  meanwhile.
+
+  Returns zero once every value has been visited, or the first nonzero value
+  `func` returns, which ends the visit early.
+  */
+  WG14_SIGNALS_EXTERN int WG14_SIGNALS_PREFIX(tss_async_signal_safe_for_each)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val,
+  int (*func)(void *value, void *arg), void *arg);
+  /*! \brief THREADSAFE Shrink the storage of an async signal safe thread
+  local instance to fit the threads currently registered with it
+
+  The table of registered threads grows as threads register, and shrinks by
+  itself only once fewer than an eighth of its slots are in use, when a thread
+  exits. This shrinks it to a quarter full, if that is smaller, and frees the
+  tables it superseded, unless a concurrent reader may still be using them.
+  Concurrent `tss_async_signal_safe_get()` calls never wait for it. An
+  instance created with a nonzero `max_threads` keeps its storage. Not async
+  signal safe.
+  */
+  WG14_SIGNALS_EXTERN int WG14_SIGNALS_PREFIX(tss_async_signal_safe_compact)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val);
+  //! \brief Counters of an async signal safe thread local instance's storage
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats_t)
+  {
+    size_t threads;      //!< Threads registered with the instance.
+    size_t capacity;     //!< Slots in its current table.
+    size_t bytes;        //!< Bytes its tables occupy, including superseded
+                         //!< ones not yet freed.
+    size_t shrinks;      //!< Times its table has shrunk.
+    size_t bytes_saved;  //!< Bytes of superseded tables freed in total.
+  };
+  /*! \brief THREADSAFE Fill in the storage counters of an async signal safe
+  thread local instance. Not async signal safe.
+  */
+  WG14_SIGNALS_EXTERN void WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats)(
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) val,
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats_t) * stats);
 
 #ifdef __cplusplus
 }
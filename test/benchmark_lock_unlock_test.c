@@ -0,0 +1,166 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "ticks_clock.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+// Built once per lock kind (see test/CMakeLists.txt), each build selecting its
+// kind by WG14_SIGNALS_BENCHMARK_LOCK_KIND, overriding any kind the library
+// build selected.
+#ifdef WG14_SIGNALS_BENCHMARK_LOCK_KIND
+#undef WG14_SIGNALS_LOCK_KIND
+#define WG14_SIGNALS_LOCK_KIND WG14_SIGNALS_BENCHMARK_LOCK_KIND
+#endif
+
+#include "wg14_signals/detail/impl/lock_unlock.h"
+
+#define STRINGIZE2(x) #x
+#define STRINGIZE(x) STRINGIZE2(x)
+
+// The thread count ladder goes 1, 2, 4, ... MAX_THREADS. Every rung runs for
+// NS_PER_RUN, and each thread keeps its last SAMPLES_PER_THREAD acquire to
+// release timings for the latency percentiles.
+#define MAX_THREADS 16
+#define NS_PER_RUN 100000000
+#define SAMPLES_PER_THREAD 65536
+
+// Every thread takes the same lock to bump a shared counter, the shape of the
+// library's writer paths under contention. Fairness is the fewest acquisitions
+// any thread made relative to the most: one means every thread got an equal
+// share, near zero means some threads starved.
+
+static atomic_int go;
+static atomic_int stop;
+static atomic_int ready;
+static atomic_uint lock;
+static cpu_ticks_count counter;
+
+struct worker_state
+{
+  cpu_ticks_count ops;
+  cpu_ticks_count *samples;
+};
+
+static int worker(void *arg)
+{
+  struct worker_state *ws = (struct worker_state *) arg;
+  atomic_fetch_add_explicit(&ready, 1, memory_order_acq_rel);
+  while(!atomic_load_explicit(&go, memory_order_acquire))
+  {
+  }
+  while(!atomic_load_explicit(&stop, memory_order_relaxed))
+  {
+    const cpu_ticks_count s = get_ticks_count(memory_order_relaxed);
+    LOCK(lock);
+    counter++;
+    UNLOCK(lock);
+    const cpu_ticks_count e = get_ticks_count(memory_order_relaxed);
+    ws->samples[ws->ops++ % SAMPLES_PER_THREAD] = e - s;
+  }
+  return 0;
+}
+
+static int compare_ticks(const void *a, const void *b)
+{
+  const cpu_ticks_count x = *(const cpu_ticks_count *) a;
+  const cpu_ticks_count y = *(const cpu_ticks_count *) b;
+  return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static cpu_ticks_count all_samples[MAX_THREADS * SAMPLES_PER_THREAD];
+static cpu_ticks_count thread_samples[MAX_THREADS][SAMPLES_PER_THREAD];
+
+int main(void)
+{
+  int ret = 0;
+  puts("Preparing benchmark ...");
+  {
+    const ns_count begin = get_ns_count();
+    ns_count end = begin;
+    do
+    {
+    } while(end = get_ns_count(), end - begin < 1000000000);
+  }
+  const cpu_ticks_count ticks_per_sec = ticks_per_second();
+  printf("There are %llu ticks per second.\n",
+         (unsigned long long) ticks_per_sec);
+  const double ns_per_tick = 1000000000.0 / (double) ticks_per_sec;
+
+  puts("Benchmarking contended LOCK()/UNLOCK() with WG14_SIGNALS_LOCK_KIND "
+       "= " STRINGIZE(WG14_SIGNALS_LOCK_KIND) " ...");
+  for(int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2)
+  {
+    thrd_t threads[MAX_THREADS];
+    struct worker_state states[MAX_THREADS];
+    memset(states, 0, sizeof(states));
+    counter = 0;
+    atomic_store_explicit(&go, 0, memory_order_relaxed);
+    atomic_store_explicit(&stop, 0, memory_order_relaxed);
+    atomic_store_explicit(&ready, 0, memory_order_relaxed);
+    for(int n = 0; n < nthreads; n++)
+    {
+      states[n].samples = thread_samples[n];
+      if(thrd_success != thrd_create(&threads[n], worker, &states[n]))
+      {
+        fprintf(stderr, "FATAL: thrd_create() failed\n");
+        return 1;
+      }
+    }
+    while(atomic_load_explicit(&ready, memory_order_acquire) != nthreads)
+    {
+    }
+    const ns_count begin = get_ns_count();
+    atomic_store_explicit(&go, 1, memory_order_release);
+    ns_count end = begin;
+    do
+    {
+      const struct timespec tick = {0, 1000000};
+      thrd_sleep(&tick, WG14_SIGNALS_NULLPTR);
+    } while(end = get_ns_count(), end - begin < NS_PER_RUN);
+    atomic_store_explicit(&stop, 1, memory_order_relaxed);
+    for(int n = 0; n < nthreads; n++)
+    {
+      int res = 0;
+      thrd_join(threads[n], &res);
+    }
+    end = get_ns_count();
+    cpu_ticks_count ops = 0, least = (cpu_ticks_count) -1, most = 0;
+    size_t samples = 0;
+    for(int n = 0; n < nthreads; n++)
+    {
+      ops += states[n].ops;
+      least = (states[n].ops < least) ? states[n].ops : least;
+      most = (states[n].ops > most) ? states[n].ops : most;
+      const size_t count = (states[n].ops < SAMPLES_PER_THREAD)
+                           ? (size_t) states[n].ops
+                           : SAMPLES_PER_THREAD;
+      memcpy(all_samples + samples, states[n].samples,
+             count * sizeof(cpu_ticks_count));
+      samples += count;
+    }
+    // Every acquisition bumped the counter exactly once.
+    CHECK(counter == ops);
+    qsort(all_samples, samples, sizeof(cpu_ticks_count), compare_ticks);
+#define PERCENTILE(p)                                                          \
+  ((samples == 0)                                                              \
+   ? 0.0                                                                       \
+   : (double) all_samples[(size_t) ((double) (samples - 1) * (p))] *           \
+     ns_per_tick)
+    printf("  %2d threads: %12.0f locks/sec, p50 %9.1f ns, p99 %9.1f ns, "
+           "p99.9 %9.1f ns, fairness %4.2f\n",
+           nthreads,
+           (double) ops / ((double) (end - begin) / 1000000000.0),
+           PERCENTILE(0.5), PERCENTILE(0.99), PERCENTILE(0.999),
+           (most == 0) ? 1.0 : (double) least / (double) most);
+#undef PERCENTILE
+  }
+  printf("\nWG14_SIGNALS_LOCK_KIND_SPIN = %d, WG14_SIGNALS_LOCK_KIND_BACKOFF = "
+         "%d, WG14_SIGNALS_LOCK_KIND_TICKET = %d.\n\n",
+         WG14_SIGNALS_LOCK_KIND_SPIN, WG14_SIGNALS_LOCK_KIND_BACKOFF,
+         WG14_SIGNALS_LOCK_KIND_TICKET);
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
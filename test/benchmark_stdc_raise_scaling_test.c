@@ -0,0 +1,165 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "ticks_clock.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define STRINGIZE2(x) #x
+#define STRINGIZE(x) STRINGIZE2(x)
+
+#ifdef __FILC__
+#define SIGNAL_TO_USE SIGUSR1
+#else
+#define SIGNAL_TO_USE SIGILL
+#endif
+
+// How many threads the scaling ladder goes up to (1, 2, 4, ... MAX_THREADS),
+// and how long each rung runs for.
+#define MAX_THREADS 16
+#define NS_PER_STEP 1000000000
+
+// Every thread raises the same signal through the same globally installed
+// decider, so any lock or shared refcount on the dispatch path shows up as
+// throughput which stops growing with the thread count.
+
+static atomic_int go;
+static atomic_int stop;
+static atomic_int ready;
+
+struct worker_state
+{
+  cpu_ticks_count ops;
+  int failed;
+};
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+claiming_decider_func(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static int worker(void *arg)
+{
+  struct worker_state *ws = (struct worker_state *) arg;
+  // The first raise on a thread sets up its per-thread state, keep that out of
+  // the measurement.
+  if(!WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                      WG14_SIGNALS_NULLPTR))
+  {
+    ws->failed = 1;
+  }
+  atomic_fetch_add_explicit(&ready, 1, memory_order_acq_rel);
+  while(!atomic_load_explicit(&go, memory_order_acquire))
+  {
+  }
+  cpu_ticks_count ops = 0;
+  while(!atomic_load_explicit(&stop, memory_order_relaxed))
+  {
+    for(size_t n = 0; n < 1024; n++)
+    {
+      if(!WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR))
+      {
+        ws->failed = 1;
+      }
+    }
+    ops += 1024;
+  }
+  ws->ops = ops;
+  return 0;
+}
+
+int main(void)
+{
+  int ret = 0;
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(WG14_SIGNALS_NULLPTR);
+  if(handlers == WG14_SIGNALS_NULLPTR)
+  {
+    fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+    return 1;
+  }
+  sigset_t guarded;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value = {.int_value = 0};
+  void *decider = WG14_SIGNALS_PREFIX(signal_decider_create)(
+  &guarded, false, claiming_decider_func, value);
+  CHECK(decider != WG14_SIGNALS_NULLPTR);
+
+  puts("Preparing benchmark ...");
+  {
+    const ns_count begin = get_ns_count();
+    ns_count end = begin;
+    do
+    {
+    } while(end = get_ns_count(), end - begin < 1000000000);
+  }
+  printf("There are %llu ticks per second.\n",
+         (unsigned long long) ticks_per_second());
+
+  puts("Benchmarking concurrent stdc_raise() through one global decider ...");
+  double single_thread_rate = 0;
+  for(int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2)
+  {
+    thrd_t threads[MAX_THREADS];
+    struct worker_state states[MAX_THREADS];
+    memset(states, 0, sizeof(states));
+    atomic_store_explicit(&go, 0, memory_order_relaxed);
+    atomic_store_explicit(&stop, 0, memory_order_relaxed);
+    atomic_store_explicit(&ready, 0, memory_order_relaxed);
+    for(int n = 0; n < nthreads; n++)
+    {
+      if(thrd_success != thrd_create(&threads[n], worker, &states[n]))
+      {
+        fprintf(stderr, "FATAL: thrd_create() failed\n");
+        return 1;
+      }
+    }
+    while(atomic_load_explicit(&ready, memory_order_acquire) != nthreads)
+    {
+    }
+    const ns_count begin = get_ns_count();
+    atomic_store_explicit(&go, 1, memory_order_release);
+    ns_count end = begin;
+    do
+    {
+      const struct timespec tick = {0, 1000000};
+      thrd_sleep(&tick, WG14_SIGNALS_NULLPTR);
+    } while(end = get_ns_count(), end - begin < NS_PER_STEP);
+    atomic_store_explicit(&stop, 1, memory_order_relaxed);
+    cpu_ticks_count ops = 0;
+    for(int n = 0; n < nthreads; n++)
+    {
+      int res = 0;
+      thrd_join(threads[n], &res);
+      CHECK(states[n].failed == 0);
+      ops += states[n].ops;
+    }
+    end = get_ns_count();
+    const double rate = (double) ops / ((double) (end - begin) / 1000000000.0);
+    if(nthreads == 1)
+    {
+      single_thread_rate = rate;
+    }
+    printf("  %2d threads: %14.0f raises/sec in total (%6.2fx one thread), "
+           "%8.2f nanoseconds per raise per thread.\n",
+           nthreads, rate, rate / single_thread_rate,
+           (double) nthreads * 1000000000.0 / rate);
+  }
+  printf("\nOn this platform (WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL "
+         "= " STRINGIZE(WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL) "), "
+         "aggregate throughput should grow linearly until the thread count "
+         "exceeds the CPU count.\n\n");
+
+  CHECK(WG14_SIGNALS_PREFIX(signal_decider_destroy)(decider) == 0);
+  CHECK(WG14_SIGNALS_PREFIX(siguninstall)(handlers) == 0);
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
@@ -0,0 +1,343 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "ticks_clock.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define STRINGIZE2(x) #x
+#define STRINGIZE(x) STRINGIZE2(x)
+
+#ifdef __FILC__
+#define SIGNAL_TO_USE SIGUSR1
+#else
+#define SIGNAL_TO_USE SIGILL
+#endif
+
+// The thread count ladder goes 1, 2, 4, ... MAX_THREADS. Every rung runs for
+// NS_PER_RUN, and each thread keeps its last SAMPLES_PER_THREAD per-operation
+// timings for the latency percentiles.
+#define MAX_THREADS 16
+#define NS_PER_RUN 100000000
+#define SAMPLES_PER_THREAD 65536
+#define BATCH 256
+
+/* Each operation is one sigguarded() entered inside the worker's other
+`depth - 1` (already entered) sigguarded() frames, inside which the signal is
+raised with stdc_raise(). Every frame guards the signal and its decider
+declines, as do all but the last of the globally installed deciders, so every
+raise walks every frame and every global decider before being claimed: by the
+last global decider, or by the outermost frame when there are none.
+
+The churn runs add one more thread which does nothing but
+signal_decider_create() and signal_decider_destroy() for the raised signal,
+so contention between the registry's writers and the raise path shows up in
+the raise latencies.
+*/
+
+static atomic_int go;
+static atomic_int stop;
+static atomic_int ready;
+
+static int global_decider_count;
+static int nesting_depth;
+
+struct worker_state
+{
+  int depth;
+  int failed;
+  cpu_ticks_count ops;
+  cpu_ticks_count *samples;
+};
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+declining_decider_func(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_next_decider);
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+claiming_decider_func(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+raising_func(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  struct worker_state *ws = (struct worker_state *) value.ptr_value;
+  if(!WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                      WG14_SIGNALS_NULLPTR))
+  {
+    ws->failed = 1;
+  }
+  return value;
+}
+
+// The outermost frame claims the raise if no global decider will.
+static WG14_SIGNALS_PREFIX(sig_decide_t) *
+frame_decider(const struct worker_state *ws)
+{
+  return (global_decider_count == 0 && ws->depth == nesting_depth)
+         ? claiming_decider_func
+         : declining_decider_func;
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+nesting_func(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  struct worker_state *ws = (struct worker_state *) value.ptr_value;
+  sigset_t guarded;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  if(ws->depth > 1)
+  {
+    // Enter one more of the outer frames.
+    WG14_SIGNALS_PREFIX(sig_decide_t) *decider = frame_decider(ws);
+    ws->depth--;
+    WG14_SIGNALS_PREFIX(sigguarded)
+    (&guarded, nesting_func, WG14_SIGNALS_NULLPTR, decider, value);
+    ws->depth++;
+    return value;
+  }
+  WG14_SIGNALS_PREFIX(sig_decide_t) *decider = frame_decider(ws);
+  while(!atomic_load_explicit(&stop, memory_order_relaxed))
+  {
+    for(size_t n = 0; n < BATCH; n++)
+    {
+      const cpu_ticks_count s = get_ticks_count(memory_order_relaxed);
+      WG14_SIGNALS_PREFIX(sigguarded)
+      (&guarded, raising_func, WG14_SIGNALS_NULLPTR, decider, value);
+      const cpu_ticks_count e = get_ticks_count(memory_order_relaxed);
+      ws->samples[ws->ops++ % SAMPLES_PER_THREAD] = e - s;
+    }
+  }
+  return value;
+}
+
+static int worker(void *arg)
+{
+  struct worker_state *ws = (struct worker_state *) arg;
+  sigset_t guarded;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  value.ptr_value = ws;
+  // The first raise on a thread sets up its per-thread state, keep that out of
+  // the measurement.
+  WG14_SIGNALS_PREFIX(sigguarded)
+  (&guarded, raising_func, WG14_SIGNALS_NULLPTR, claiming_decider_func, value);
+  atomic_fetch_add_explicit(&ready, 1, memory_order_acq_rel);
+  while(!atomic_load_explicit(&go, memory_order_acquire))
+  {
+  }
+  ws->depth = nesting_depth;
+  (void) nesting_func(value);
+  return 0;
+}
+
+static int churn_worker(void *arg)
+{
+  cpu_ticks_count *ops = (cpu_ticks_count *) arg;
+  sigset_t guarded;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  value.int_value = 0;
+  atomic_fetch_add_explicit(&ready, 1, memory_order_acq_rel);
+  while(!atomic_load_explicit(&go, memory_order_acquire))
+  {
+  }
+  while(!atomic_load_explicit(&stop, memory_order_relaxed))
+  {
+    // Alternate front and back insertion, so both ends of the published
+    // decider array are rebuilt.
+    void *d = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &guarded, (*ops & 1) != 0, declining_decider_func, value);
+    if(d != WG14_SIGNALS_NULLPTR)
+    {
+      (void) WG14_SIGNALS_PREFIX(signal_decider_destroy)(d);
+      ++*ops;
+    }
+  }
+  return 0;
+}
+
+static int compare_ticks(const void *a, const void *b)
+{
+  const cpu_ticks_count x = *(const cpu_ticks_count *) a;
+  const cpu_ticks_count y = *(const cpu_ticks_count *) b;
+  return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static cpu_ticks_count all_samples[MAX_THREADS * SAMPLES_PER_THREAD];
+static cpu_ticks_count thread_samples[MAX_THREADS][SAMPLES_PER_THREAD];
+
+// Returns the number of failed raises.
+static int run(const int nthreads, const bool churn,
+               const double ns_per_tick)
+{
+  thrd_t threads[MAX_THREADS + 1];
+  struct worker_state states[MAX_THREADS];
+  cpu_ticks_count churn_ops = 0;
+  memset(states, 0, sizeof(states));
+  atomic_store_explicit(&go, 0, memory_order_relaxed);
+  atomic_store_explicit(&stop, 0, memory_order_relaxed);
+  atomic_store_explicit(&ready, 0, memory_order_relaxed);
+  for(int n = 0; n < nthreads; n++)
+  {
+    states[n].samples = thread_samples[n];
+    if(thrd_success != thrd_create(&threads[n], worker, &states[n]))
+    {
+      fprintf(stderr, "FATAL: thrd_create() failed\n");
+      exit(1);
+    }
+  }
+  if(churn &&
+     thrd_success != thrd_create(&threads[nthreads], churn_worker, &churn_ops))
+  {
+    fprintf(stderr, "FATAL: thrd_create() failed\n");
+    exit(1);
+  }
+  const int total = nthreads + (churn ? 1 : 0);
+  while(atomic_load_explicit(&ready, memory_order_acquire) != total)
+  {
+  }
+  const ns_count begin = get_ns_count();
+  atomic_store_explicit(&go, 1, memory_order_release);
+  ns_count end = begin;
+  do
+  {
+    const struct timespec tick = {0, 1000000};
+    thrd_sleep(&tick, WG14_SIGNALS_NULLPTR);
+  } while(end = get_ns_count(), end - begin < NS_PER_RUN);
+  atomic_store_explicit(&stop, 1, memory_order_relaxed);
+  int failed = 0;
+  cpu_ticks_count ops = 0;
+  size_t samples = 0;
+  for(int n = 0; n < total; n++)
+  {
+    int res = 0;
+    thrd_join(threads[n], &res);
+  }
+  end = get_ns_count();
+  for(int n = 0; n < nthreads; n++)
+  {
+    failed += states[n].failed;
+    ops += states[n].ops;
+    const size_t count = (states[n].ops < SAMPLES_PER_THREAD)
+                         ? (size_t) states[n].ops
+                         : SAMPLES_PER_THREAD;
+    memcpy(all_samples + samples, states[n].samples,
+           count * sizeof(cpu_ticks_count));
+    samples += count;
+  }
+  qsort(all_samples, samples, sizeof(cpu_ticks_count), compare_ticks);
+  const double secs = (double) (end - begin) / 1000000000.0;
+#define PERCENTILE(p)                                                          \
+  ((samples == 0)                                                              \
+   ? 0.0                                                                       \
+   : (double) all_samples[(size_t) ((double) (samples - 1) * (p))] *           \
+     ns_per_tick)
+  printf("  %2d threads: %12.0f ops/sec, p50 %9.1f ns, p99 %9.1f ns, "
+         "p99.9 %9.1f ns",
+         nthreads, (double) ops / secs, PERCENTILE(0.5), PERCENTILE(0.99),
+         PERCENTILE(0.999));
+#undef PERCENTILE
+  if(churn)
+  {
+    printf(", %10.0f decider create+destroy/sec",
+           (double) churn_ops / secs);
+  }
+  printf("\n");
+  return failed;
+}
+
+int main(void)
+{
+  int ret = 0;
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(WG14_SIGNALS_NULLPTR);
+  if(handlers == WG14_SIGNALS_NULLPTR)
+  {
+    fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+    return 1;
+  }
+  sigset_t guarded;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+
+  puts("Preparing benchmark ...");
+  {
+    const ns_count begin = get_ns_count();
+    ns_count end = begin;
+    do
+    {
+    } while(end = get_ns_count(), end - begin < 1000000000);
+  }
+  const cpu_ticks_count ticks_per_sec = ticks_per_second();
+  printf("There are %llu ticks per second.\n",
+         (unsigned long long) ticks_per_sec);
+  const double ns_per_tick = 1000000000.0 / (double) ticks_per_sec;
+
+  static const int decider_counts[] = {0, 1, 10};
+  static const int depths[] = {1, 4, 16};
+  void *deciders[10];
+  for(size_t d = 0; d < sizeof(decider_counts) / sizeof(int); d++)
+  {
+    global_decider_count = decider_counts[d];
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    value.int_value = 0;
+    for(int n = 0; n < global_decider_count; n++)
+    {
+      deciders[n] = WG14_SIGNALS_PREFIX(signal_decider_create)(
+      &guarded, false,
+      (n == global_decider_count - 1) ? claiming_decider_func
+                                      : declining_decider_func,
+      value);
+      CHECK(deciders[n] != WG14_SIGNALS_NULLPTR);
+    }
+    for(size_t r = 0; r < sizeof(depths) / sizeof(int); r++)
+    {
+      nesting_depth = depths[r];
+      printf("\nsigguarded() + stdc_raise() with %d global deciders and "
+             "%d nested frames:\n",
+             global_decider_count, nesting_depth);
+      for(int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2)
+      {
+        const int failed = run(nthreads, false, ns_per_tick);
+        CHECK(failed == 0);
+      }
+    }
+    if(global_decider_count == 1)
+    {
+      nesting_depth = 1;
+      printf("\nsigguarded() + stdc_raise() with %d global deciders and "
+             "%d nested frames, with concurrent decider churn:\n",
+             global_decider_count, nesting_depth);
+      for(int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2)
+      {
+        const int failed = run(nthreads, true, ns_per_tick);
+        CHECK(failed == 0);
+      }
+    }
+    for(int n = 0; n < global_decider_count; n++)
+    {
+      CHECK(WG14_SIGNALS_PREFIX(signal_decider_destroy)(deciders[n]) == 0);
+    }
+  }
+  printf("\nOn this platform (WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL "
+         "= " STRINGIZE(WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL) "), "
+         "throughput should grow linearly and latencies stay flat until the "
+         "thread count exceeds the CPU count.\n\n");
+
+  CHECK(WG14_SIGNALS_PREFIX(siguninstall)(handlers) == 0);
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
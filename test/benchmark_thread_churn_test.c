@@ -0,0 +1,191 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+// Compiled into this TU, so that the same source builds once with the
+// platform's async-signal-safe thread locals and once with the fallback hash
+// table (WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL=0).
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "ticks_clock.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define STRINGIZE2(x) #x
+#define STRINGIZE(x) STRINGIZE2(x)
+
+// How many short-lived threads each pass spawns and joins, one at a time as
+// a churning thread pool would.
+#define CHURN_THREADS 4000
+
+// The first library use on a new thread sets the thread up: it is given an
+// index and generation, its signal handling state is allocated, and its
+// deinitialisation registered for thread exit, where it is torn down again.
+// Each thread here does one sigguarded() and one tss_async_signal_safe_get()
+// (after the tss_async_signal_safe_thread_init() it needs), and the time to
+// spawn and join it is compared with that of a thread which does nothing.
+
+static WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) tls;
+static int tls_value;
+static sigset_t guarded;
+
+struct thread_costs
+{
+  cpu_ticks_count first_sigguarded, first_get;
+  cpu_ticks_count sigguarded, get;
+  int failed;
+};
+
+static int tls_create(void **dest)
+{
+  *dest = &tls_value;
+  return 0;
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+guarded_func(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  return value;
+}
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+recovery_func(const struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  return rsi->value;
+}
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+decider_func(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_call_recovery);
+}
+
+static int empty_thread(void *arg)
+{
+  (void) arg;
+  return 0;
+}
+
+static void use_library(cpu_ticks_count *sigguarded_ticks,
+                        cpu_ticks_count *get_ticks, int *failed)
+{
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value = {.int_value = 1};
+  cpu_ticks_count s = get_ticks_count(memory_order_relaxed);
+  value = WG14_SIGNALS_PREFIX(sigguarded)(&guarded, guarded_func,
+                                          recovery_func, decider_func, value);
+  cpu_ticks_count e = get_ticks_count(memory_order_relaxed);
+  *sigguarded_ticks = e - s;
+  s = get_ticks_count(memory_order_relaxed);
+  const int init = WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(tls);
+  void *v = WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(tls);
+  e = get_ticks_count(memory_order_relaxed);
+  *get_ticks = e - s;
+  if(value.int_value != 1 || init != 0 || v != &tls_value)
+  {
+    *failed = 1;
+  }
+}
+
+static int library_thread(void *arg)
+{
+  struct thread_costs *costs = (struct thread_costs *) arg;
+  use_library(&costs->first_sigguarded, &costs->first_get, &costs->failed);
+  // Again, now that the thread is set up.
+  use_library(&costs->sigguarded, &costs->get, &costs->failed);
+  return 0;
+}
+
+// The mean nanoseconds to spawn and join one thread running `func`.
+static double churn(int (*func)(void *), struct thread_costs *costs)
+{
+  const ns_count begin = get_ns_count();
+  for(int n = 0; n < CHURN_THREADS; n++)
+  {
+    thrd_t thr;
+    if(thrd_success != thrd_create(&thr, func, &costs[n]))
+    {
+      fprintf(stderr, "FATAL: thrd_create() failed\n");
+      exit(1);
+    }
+    thrd_join(thr, WG14_SIGNALS_NULLPTR);
+  }
+  return (double) (get_ns_count() - begin) / CHURN_THREADS;
+}
+
+int main(void)
+{
+  int ret = 0;
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(WG14_SIGNALS_NULLPTR);
+  if(handlers == WG14_SIGNALS_NULLPTR)
+  {
+    fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+    return 1;
+  }
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) attr = {
+  .create = tls_create};
+  CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(&tls, &attr));
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGILL);
+  static struct thread_costs costs[CHURN_THREADS];
+
+  puts("Preparing benchmark ...");
+  {
+    const ns_count begin = get_ns_count();
+    ns_count end = begin;
+    do
+    {
+    } while(end = get_ns_count(), end - begin < 1000000000);
+  }
+  const cpu_ticks_count ticks_per_sec = ticks_per_second();
+  printf("There are %llu ticks per second.\n",
+         (unsigned long long) ticks_per_sec);
+  const double ns_per_tick = 1000000000.0 / (double) ticks_per_sec;
+
+  printf("Benchmarking %d threads doing nothing, then %d using the library "
+         "...\n",
+         CHURN_THREADS, CHURN_THREADS);
+  // Once each first, to warm up the thread stack cache and the library.
+  (void) churn(empty_thread, costs);
+  (void) churn(library_thread, costs);
+  const double empty_ns = churn(empty_thread, costs);
+  memset(costs, 0, sizeof(costs));
+  const double library_ns = churn(library_thread, costs);
+  double first_sigguarded = 0, first_get = 0, steady_sigguarded = 0,
+         steady_get = 0;
+  for(int n = 0; n < CHURN_THREADS; n++)
+  {
+    CHECK(costs[n].failed == 0);
+    first_sigguarded += (double) costs[n].first_sigguarded * ns_per_tick;
+    first_get += (double) costs[n].first_get * ns_per_tick;
+    steady_sigguarded += (double) costs[n].sigguarded * ns_per_tick;
+    steady_get += (double) costs[n].get * ns_per_tick;
+  }
+  first_sigguarded /= CHURN_THREADS;
+  first_get /= CHURN_THREADS;
+  steady_sigguarded /= CHURN_THREADS;
+  steady_get /= CHURN_THREADS;
+  // What the library adds over the steady state costs of its calls.
+  const double setup_ns =
+  (first_sigguarded - steady_sigguarded) + (first_get - steady_get);
+  const double overhead_ns =
+  library_ns - empty_ns - steady_sigguarded - steady_get;
+  printf(
+  "\nOn this platform (WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL "
+  "= " STRINGIZE(WG14_SIGNALS_HAVE_ASYNC_SAFE_THREAD_LOCAL) "):\n"
+  "  spawning and joining a thread takes %.0f nanoseconds, or %.0f if it "
+  "uses the library;\n"
+  "  its first sigguarded() takes %.0f nanoseconds (then %.0f), and its "
+  "first thread_init() and get() %.0f (then %.0f);\n"
+  "  so per-thread setup costs %.0f nanoseconds, and teardown at thread exit "
+  "about %.0f.\n\n",
+  empty_ns, library_ns, first_sigguarded, steady_sigguarded, first_get,
+  steady_get, setup_ns, overhead_ns - setup_ns);
+
+  CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)(tls));
+  CHECK(WG14_SIGNALS_PREFIX(siguninstall)(handlers) == 0);
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
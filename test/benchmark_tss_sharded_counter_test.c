@@ -0,0 +1,182 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "ticks_clock.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+// How many threads the scaling ladder goes up to (1, 2, 4, ... MAX_THREADS),
+// and how long each rung runs for.
+#define MAX_THREADS 16
+#define NS_PER_STEP 1000000000
+
+// Every thread counts events, either into one shared atomic counter, where
+// every increment contends for the same cache line, or into its own counter
+// found with tss_async_signal_safe_get(), which a metrics thread sums with
+// tss_async_signal_safe_for_each() every millisecond meanwhile.
+
+struct shard_t
+{
+  atomic_ullong count;
+};
+
+static WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) tls;
+static atomic_ullong shared_counter;
+static atomic_int go;
+static atomic_int stop;
+static atomic_int ready;
+static int sharded;
+
+struct worker_state
+{
+  cpu_ticks_count ops;
+  int failed;
+};
+
+static int worker(void *arg)
+{
+  struct worker_state *ws = (struct worker_state *) arg;
+  if(WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(tls) != 0)
+  {
+    ws->failed = 1;
+  }
+  atomic_fetch_add_explicit(&ready, 1, memory_order_acq_rel);
+  while(!atomic_load_explicit(&go, memory_order_acquire))
+  {
+  }
+  cpu_ticks_count ops = 0;
+  while(!atomic_load_explicit(&stop, memory_order_relaxed))
+  {
+    for(size_t n = 0; n < 1024; n++)
+    {
+      if(sharded)
+      {
+        // Only this thread writes its shard, so no read-modify-write is
+        // needed, just an atomic store for the metrics thread to read.
+        struct shard_t *shard = (struct shard_t *) WG14_SIGNALS_PREFIX(
+        tss_async_signal_safe_get)(tls);
+        atomic_store_explicit(
+        &shard->count,
+        atomic_load_explicit(&shard->count, memory_order_relaxed) + 1,
+        memory_order_relaxed);
+      }
+      else
+      {
+        atomic_fetch_add_explicit(&shared_counter, 1, memory_order_relaxed);
+      }
+    }
+    ops += 1024;
+  }
+  ws->ops = ops;
+  return 0;
+}
+
+static int sum_shard(void *value, void *arg)
+{
+  *(unsigned long long *) arg += atomic_load_explicit(
+  &((struct shard_t *) value)->count, memory_order_relaxed);
+  return 0;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) attr = {
+  .value_size = sizeof(struct shard_t)};
+  CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(&tls, &attr));
+
+  puts("Preparing benchmark ...");
+  {
+    const ns_count begin = get_ns_count();
+    ns_count end = begin;
+    do
+    {
+    } while(end = get_ns_count(), end - begin < 1000000000);
+  }
+  printf("There are %llu ticks per second.\n",
+         (unsigned long long) ticks_per_second());
+
+  for(sharded = 0; sharded < 2; sharded++)
+  {
+    puts(sharded ? "Benchmarking per-thread counters summed by for_each() ..."
+                 : "Benchmarking one shared atomic counter ...");
+    double single_thread_rate = 0;
+    for(int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2)
+    {
+      thrd_t threads[MAX_THREADS];
+      struct worker_state states[MAX_THREADS];
+      memset(states, 0, sizeof(states));
+      atomic_store_explicit(&go, 0, memory_order_relaxed);
+      atomic_store_explicit(&stop, 0, memory_order_relaxed);
+      atomic_store_explicit(&ready, 0, memory_order_relaxed);
+      atomic_store_explicit(&shared_counter, 0, memory_order_relaxed);
+      for(int n = 0; n < nthreads; n++)
+      {
+        if(thrd_success != thrd_create(&threads[n], worker, &states[n]))
+        {
+          fprintf(stderr, "FATAL: thrd_create() failed\n");
+          return 1;
+        }
+      }
+      while(atomic_load_explicit(&ready, memory_order_acquire) != nthreads)
+      {
+      }
+      const ns_count begin = get_ns_count();
+      atomic_store_explicit(&go, 1, memory_order_release);
+      ns_count end = begin;
+      unsigned long long sums = 0;
+      do
+      {
+        const struct timespec tick = {0, 1000000};
+        thrd_sleep(&tick, WG14_SIGNALS_NULLPTR);
+        if(sharded)
+        {
+          unsigned long long total = 0;
+          (void) WG14_SIGNALS_PREFIX(tss_async_signal_safe_for_each)(
+          tls, sum_shard, &total);
+          sums++;
+        }
+      } while(end = get_ns_count(), end - begin < NS_PER_STEP);
+      atomic_store_explicit(&stop, 1, memory_order_relaxed);
+      cpu_ticks_count ops = 0;
+      for(int n = 0; n < nthreads; n++)
+      {
+        int res = 0;
+        thrd_join(threads[n], &res);
+        CHECK(states[n].failed == 0);
+        ops += states[n].ops;
+      }
+      end = get_ns_count();
+      if(!sharded)
+      {
+        CHECK(atomic_load(&shared_counter) == ops);
+      }
+      const double rate =
+      (double) ops / ((double) (end - begin) / 1000000000.0);
+      if(nthreads == 1)
+      {
+        single_thread_rate = rate;
+      }
+      printf("  %2d threads: %14.0f increments/sec in total (%6.2fx one "
+             "thread), %8.2f nanoseconds per increment per thread",
+             nthreads, rate, rate / single_thread_rate,
+             (double) nthreads * 1000000000.0 / rate);
+      if(sharded)
+      {
+        printf(", %llu sums", sums);
+      }
+      printf(".\n");
+    }
+  }
+  puts("\nThe shared counter's aggregate throughput should stop growing, or "
+       "fall, once there is more than one CPU; the per-thread counters' "
+       "should grow linearly until the thread count exceeds the CPU count.\n");
+
+  CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)(tls));
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
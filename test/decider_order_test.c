@@ -0,0 +1,150 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+// Fil-C's runtime reserves SIGILL/SIGTRAP/SIGBUS/SIGSEGV/SIGFPE for its own
+// memory-safety mechanism, so the in-tree tests use SIGUSR2 there; SIGABRT is
+// defined and installable everywhere else, including Windows/MSVC.
+#ifdef __FILC__
+#define SIGNAL_TO_USE SIGUSR2
+#else
+#define SIGNAL_TO_USE SIGABRT
+#endif
+
+// Global deciders are published as a packed array rebuilt on every
+// registration change: callfirst deciders are inserted at the front, the rest
+// at the back. Check the invocation order survives creates and destroys, and
+// that a decider which abandons and resumes the raise (while registrations
+// change under it) resumes the walk after itself in the new array.
+
+#define DECIDERS 10
+
+static void *handles[DECIDERS + 1];
+static int invoked[2 * DECIDERS];
+static int invoked_count = 0;
+static intptr_t claim_value = -1;
+static intptr_t churn_value = -1;
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+logging_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  const intptr_t v = rsi->value.int_value;
+  if(invoked_count < 2 * DECIDERS)
+  {
+    invoked[invoked_count++] = (int) v;
+  }
+  if(v == churn_value)
+  {
+    churn_value = -1;
+    WG14_SIGNALS_PREFIX(sigdecider_abandon)(rsi);
+    // While abandoned, destroy a decider later in the walk and add one at the
+    // front: the resumed walk sees neither.
+    (void) WG14_SIGNALS_PREFIX(signal_decider_destroy)(handles[1]);
+    handles[1] = WG14_SIGNALS_NULLPTR;
+    sigset_t g;
+    sigemptyset(&g);
+    sigaddset(&g, SIGNAL_TO_USE);
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    value.int_value = DECIDERS;
+    handles[DECIDERS] = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &g, true, logging_decider, value);
+    WG14_SIGNALS_PREFIX(sigdecider_abandon_resume)(rsi);
+  }
+  return (v == claim_value)
+         ? WG14_SIGNALS_PREFIX(sig_decision_resume_execution)
+         : WG14_SIGNALS_PREFIX(sig_decision_next_decider);
+}
+
+static int check_order(const int *expected, int count)
+{
+  if(invoked_count != count)
+  {
+    fprintf(stderr, "Expected %d invocations, got %d\n", count, invoked_count);
+    return 0;
+  }
+  for(int n = 0; n < count; n++)
+  {
+    if(invoked[n] != expected[n])
+    {
+      fprintf(stderr, "Invocation %d was decider %d, expected %d\n", n,
+              invoked[n], expected[n]);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int main(void)
+{
+  int ret = 0;
+  sigset_t g;
+  sigemptyset(&g);
+  sigaddset(&g, SIGNAL_TO_USE);
+  void *h = WG14_SIGNALS_PREFIX(siginstall)(&g);
+  CHECK(h != WG14_SIGNALS_NULLPTR);
+
+  // Odd deciders are callfirst, so they run most recent first ahead of the
+  // even ones, which run in creation order.
+  for(int n = 0; n < DECIDERS; n++)
+  {
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    value.int_value = n;
+    handles[n] = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &g, (n & 1) != 0, logging_decider, value);
+    CHECK(handles[n] != WG14_SIGNALS_NULLPTR);
+  }
+  claim_value = 8;
+  {
+    static const int expected[] = {9, 7, 5, 3, 1, 0, 2, 4, 6, 8};
+    invoked_count = 0;
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(check_order(expected, 10));
+  }
+
+  // Destroying deciders from the middle and the back end keeps the relative
+  // order of the rest.
+  CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(handles[5]));
+  handles[5] = WG14_SIGNALS_NULLPTR;
+  CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(handles[0]));
+  handles[0] = WG14_SIGNALS_NULLPTR;
+  {
+    static const int expected[] = {9, 7, 3, 1, 2, 4, 6, 8};
+    invoked_count = 0;
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(check_order(expected, 8));
+  }
+
+  // Decider 3 abandons, destroys decider 1, creates callfirst decider 10 and
+  // resumes: the walk continues after 3 in the republished array.
+  churn_value = 3;
+  {
+    static const int expected[] = {9, 7, 3, 2, 4, 6, 8};
+    invoked_count = 0;
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(check_order(expected, 7));
+  }
+  CHECK(handles[DECIDERS] != WG14_SIGNALS_NULLPTR);
+  {
+    static const int expected[] = {10, 9, 7, 3, 2, 4, 6, 8};
+    invoked_count = 0;
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(check_order(expected, 8));
+  }
+
+  for(int n = 0; n <= DECIDERS; n++)
+  {
+    if(handles[n] != WG14_SIGNALS_NULLPTR)
+    {
+      CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(handles[n]));
+    }
+  }
+  CHECK(0 == WG14_SIGNALS_PREFIX(siguninstall)(h));
+  printf("decider-order checks passed\n");
+  return ret;
+}
@@ -17,10 +17,10 @@
 
 // Reentrant signal_decider_destroy() contract (N3924 7.14.2.8; plans
 // proposed-wording-fixes.md 7.3/17): calling it from within a decider function
-// is permitted. The node refcount protocol (registry ref = 1, in-flight raise
-// +1 during the unlocked decider call) defers the free of a currently
-// executing decider's node until the raise completes, and a sibling node is
-// freed with the in-flight walk relinked past it by LIST_REMOVE.
+// is permitted. Destroy marks the node dead and publishes a decider snapshot
+// without it; the node itself is only reclaimed once the raise walking the old
+// snapshot has left, and that walk skips dead nodes, so neither a currently
+// executing decider nor a destroyed sibling is touched after its free.
 
 static void *self_handle = WG14_SIGNALS_NULLPTR;
 static int self_destroy_calls = 0;
@@ -86,8 +86,8 @@ int main(void)
   union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value = {.int_value = 7};
 
   // Self-destroy: the executing decider destroys its own handle. The node is
-  // not freed while the decider is still executing (the free is deferred until
-  // the raise completes and the node is retired via deferred_frees), the
+  // not freed while the decider is still executing (it is retired, and
+  // reclaimed only after the raise completes), the
   // destroy reports 0, and a later raise no longer invokes the decider. A
   // second handle on the same signal must survive the whole sequence.
   {
@@ -125,9 +125,9 @@ int main(void)
   }
 
   // Sibling-destroy: a callfirst decider destroys a later decider's handle
-  // from within its own invocation. The mid-walk LIST_REMOVE relinks the
-  // in-flight walk so the destroyed decider is invoked by neither the same
-  // raise nor any later raise.
+  // from within its own invocation. The in-flight walk skips the now dead
+  // node, so the destroyed decider is invoked by neither the same raise nor
+  // any later raise.
   {
     sigset_t g;
     sigemptyset(&g);
@@ -61,7 +61,7 @@ int main(void)
   printf("Main thread tid = %lu\n", (unsigned long) mytid);
   CHECK(0 != mytid);
   struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
-  attr = {create, destroy};
+  attr = {create, destroy, 0, 0, 0, false};
   printf("Creating TLS ...\n");
   CHECK(-1 !=
         WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(&shared.tls, &attr));
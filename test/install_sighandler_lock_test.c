@@ -14,29 +14,35 @@
 #include "wg14_signals/thrd_signal_handle.h"
 
 // White-box regression test for analysis.md 2.20/Y1: install_sighandler()
-// returned false while still holding the global state->lock when the backend
-// install failed, permanently deadlocking every subsequent library call.
+// (now the batched install_sighandlers()) returned false while still holding
+// the global state->lock when the backend install failed, permanently
+// deadlocking every subsequent library call.
 //
 // Including the header with WG14_SIGNALS_ENABLE_HEADER_ONLY makes the internal
-// install_sighandler() and sig_global_state() per-TU statics callable from here
-// (the header_only_c_multi_test pattern, ideas.md 10). SIGKILL is the one
+// install_sighandlers() and sig_global_state() per-TU statics callable from
+// here (the header_only_c_multi_test pattern, ideas.md 10). SIGKILL is the one
 // signal the siginstall() loop skips for which sigaction() is *guaranteed* to
-// fail (EINVAL) on every POSIX platform, so calling install_sighandler(SIGKILL)
+// fail (EINVAL) on every POSIX platform, so a batch containing SIGKILL
 // deterministically drives install_sighandler_impl() to failure.
 #ifndef _WIN32
 static int whitebox_install_failure_releases_lock(void)
 {
   int ret = 0;
-  // install_sighandler(SIGKILL) -> sigaction(SIGKILL) == -1 -> the
-  // install_sighandler_impl() failure branch of install_sighandler(). Before
-  // the fix that branch returned false with state->lock still held.
-  CHECK(WG14_SIGNALS_PREFIX(install_sighandler)(SIGKILL) == false);
+  // sigaction(SIGKILL) == -1 -> the install_sighandler_impl() failure branch
+  // of install_sighandlers(). Before the fix that branch returned false with
+  // state->lock still held. SIGUSR1, installed first in the same batch, must
+  // be rolled back with it.
+  static const int signos[] = {SIGUSR1, SIGKILL};
+  CHECK(WG14_SIGNALS_PREFIX(install_sighandlers)(signos, 2) == false);
   // A fresh acquisition of the global lock must not spin: it spins forever
   // before the fix, so this is the regression check.
   struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
   WG14_SIGNALS_PREFIX(sig_global_state)();
   LOCK(state->lock);
   UNLOCK(state->lock);
+  CHECK(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals,
+                                            SIGUSR1));
+  CHECK(state->sighandlers_count == 0);
   return ret;
 }
 #endif
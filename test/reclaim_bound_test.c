@@ -0,0 +1,159 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+// A small bound and a short wait, so the test reaches both quickly.
+#define WG14_SIGNALS_RECLAIM_PENDING_LIMIT 8
+#define WG14_SIGNALS_RECLAIM_WAIT_ROUNDS 64
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// Registration changes retire what a raise may still be walking, and the
+// retired objects are freed once no raise can be. Check with the
+// sigreclaim_stats() counters that, with no raise in flight, everything
+// retired is freed at once; that a destroy from inside a decider leaves its
+// garbage for a later registration change rather than waiting on its own
+// raise; and that while another thread's raise is stuck in a decider waiting
+// on the churning thread, registration churn gives up waiting for it after
+// WG14_SIGNALS_RECLAIM_WAIT_ROUNDS rather than hang, counting each time the
+// garbage was left above WG14_SIGNALS_RECLAIM_PENDING_LIMIT.
+
+#ifdef _WIN32
+#define SIGNAL_TO_USE SIGFPE
+#else
+#define SIGNAL_TO_USE SIGUSR1
+#endif
+
+#define CHURN 200
+
+static sigset_t guarded;
+static void *victim;
+static atomic_int in_decider;
+static atomic_int release;
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+claiming_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+destroying_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  if(victim != WG14_SIGNALS_NULLPTR)
+  {
+    (void) WG14_SIGNALS_PREFIX(signal_decider_destroy)(victim);
+    victim = WG14_SIGNALS_NULLPTR;
+  }
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+blocking_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  atomic_store(&in_decider, 1);
+  while(!atomic_load(&release))
+  {
+  }
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static int raiser(void *arg)
+{
+  (void) arg;
+  return WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                         WG14_SIGNALS_NULLPTR)
+         ? 0
+         : 1;
+}
+
+int main(void)
+{
+  int ret = 0;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(&guarded);
+  if(handlers == WG14_SIGNALS_NULLPTR)
+  {
+    fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+    return 1;
+  }
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  value.int_value = 0;
+  struct WG14_SIGNALS_PREFIX(sigreclaim_stats_t) stats;
+
+  SECTION("no raise in flight: everything retired is freed at once");
+  {
+    void *d = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &guarded, false, claiming_decider, value);
+    CHECK(d != WG14_SIGNALS_NULLPTR);
+    CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(d));
+    WG14_SIGNALS_PREFIX(sigreclaim_stats)(&stats);
+    CHECK(stats.retired >= 2);
+    CHECK(stats.pending == 0);
+    CHECK(stats.reclaimed == stats.retired);
+  }
+
+  SECTION("a destroy from inside a decider does not wait on its own raise");
+  {
+    void *d = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &guarded, true, destroying_decider, value);
+    victim = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &guarded, false, claiming_decider, value);
+    CHECK(d != WG14_SIGNALS_NULLPTR && victim != WG14_SIGNALS_NULLPTR);
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(victim == WG14_SIGNALS_NULLPTR);
+    WG14_SIGNALS_PREFIX(sigreclaim_stats)(&stats);
+    CHECK(stats.pending > 0);
+    // The next registration change frees it.
+    CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(d));
+    WG14_SIGNALS_PREFIX(sigreclaim_stats)(&stats);
+    CHECK(stats.pending == 0);
+  }
+
+  SECTION("churn against a raise waiting on it does not hang");
+  {
+    void *blocker = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &guarded, false, blocking_decider, value);
+    CHECK(blocker != WG14_SIGNALS_NULLPTR);
+    thrd_t raise_thread;
+    CHECK(thrd_success ==
+          thrd_create(&raise_thread, raiser, WG14_SIGNALS_NULLPTR));
+    while(!atomic_load(&in_decider))
+    {
+    }
+    // The decider is released only once the churn is done.
+    for(int n = 0; n < CHURN; n++)
+    {
+      void *d = WG14_SIGNALS_PREFIX(signal_decider_create)(
+      &guarded, (n & 1) != 0, claiming_decider, value);
+      CHECK(d != WG14_SIGNALS_NULLPTR);
+      CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(d));
+    }
+    WG14_SIGNALS_PREFIX(sigreclaim_stats)(&stats);
+    CHECK(stats.pending > WG14_SIGNALS_RECLAIM_PENDING_LIMIT);
+    CHECK(stats.waits_abandoned > 0);
+    atomic_store(&release, 1);
+    int res = 0;
+    thrd_join(raise_thread, &res);
+    CHECK(res == 0);
+    // The next registration change frees what was left pending.
+    CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(blocker));
+    WG14_SIGNALS_PREFIX(sigreclaim_stats)(&stats);
+    CHECK(stats.pending == 0);
+    CHECK(stats.reclaimed == stats.retired);
+  }
+
+  CHECK(0 == WG14_SIGNALS_PREFIX(siguninstall)(handlers));
+  printf("reclaim bound checks passed\n");
+  return ret;
+}
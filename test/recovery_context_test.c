@@ -0,0 +1,196 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+// Compiled into this TU, so that the same source builds once with a jmp_buf
+// in each guarded frame and once with the compact recovery context
+// (WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT=1), whichever the library was
+// configured with.
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <signal.h>
+
+// Recovering from a guarded signal must resume in the right frame with the
+// caller's state intact, and hand the recovery the siginfo of the raise that
+// asked for it. Check recovery into the inner of two guards, past an inner
+// guard without a recovery function into the outer one, from a recovery which
+// itself guards and recovers, and that values live in callee-saved registers
+// across the guard survive it. Fil-C's runtime reserves SIGILL for its own
+// memory-safety mechanism, so the test uses SIGUSR2 there.
+#ifdef __FILC__
+#define SIGNAL_TO_USE SIGUSR2
+#else
+#define SIGNAL_TO_USE SIGILL
+#endif
+
+typedef union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value_t;
+typedef struct WG14_SIGNALS_PREFIX(stdc_siginfo) rsi_t;
+
+static sigset_t guarded;
+static int recovered_signo;
+static int recovered_value;
+static int nested_ok;
+static int outer_recovered;
+
+static value_t make_value(int v)
+{
+  value_t ret;
+  ret.int_value = v;
+  return ret;
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision) recover_decider(rsi_t *rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_call_recovery);
+}
+
+static value_t raising_func(value_t value)
+{
+  (void) WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                         WG14_SIGNALS_NULLPTR);
+  // Never reached, the raise always recovers.
+  return make_value(value.int_value - 1000);
+}
+
+static value_t recovery_func(const rsi_t *rsi)
+{
+  recovered_signo = rsi->signo;
+  recovered_value = rsi->value.int_value;
+  return make_value(rsi->value.int_value + 100);
+}
+
+static value_t guard_raise(int v)
+{
+  return WG14_SIGNALS_PREFIX(sigguarded)(&guarded, raising_func, recovery_func,
+                                         recover_decider, make_value(v));
+}
+
+static value_t guard_raise_func(value_t value)
+{
+  return make_value(guard_raise(value.int_value).int_value + 1);
+}
+
+static value_t outer_recovery_func(const rsi_t *rsi)
+{
+  outer_recovered = 1;
+  return rsi->value;
+}
+
+#ifndef _WIN32
+// Recovery skips an inner guard without a recovery function.
+static value_t unrecoverable_inner_func(value_t value)
+{
+  return WG14_SIGNALS_PREFIX(sigguarded)(
+  &guarded, raising_func, WG14_SIGNALS_NULLPTR, recover_decider,
+  make_value(value.int_value + 1));
+}
+#endif
+
+// A recovery which itself guards and recovers before reading its own rsi.
+static value_t guarding_recovery_func(const rsi_t *rsi)
+{
+  const int before = rsi->value.int_value;
+  const value_t inner = guard_raise(before + 10);
+  nested_ok = (inner.int_value == before + 110 &&
+               rsi->value.int_value == before && rsi->signo == SIGNAL_TO_USE);
+  return make_value(before + 1);
+}
+
+static value_t guarding_recovery_outer_func(value_t value)
+{
+  (void) value;
+  (void) WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                         WG14_SIGNALS_NULLPTR);
+  return make_value(-1);
+}
+
+// Enough values live across the guard to fill the callee-saved registers.
+static int live_across_guard(int seed)
+{
+  volatile int vseed = seed;
+  int a = vseed + 1, b = vseed * 3, c = vseed ^ 0x55, d = vseed - 7,
+      e = vseed * vseed, f = vseed + 11, g = vseed << 2, h = vseed / 3 + 5;
+  const value_t r = guard_raise(a + b);
+  return r.int_value + a + b * 2 + c * 3 + d * 5 + e * 7 + f * 11 + g * 13 +
+         h * 17;
+}
+
+static int live_expected(int seed)
+{
+  int a = seed + 1, b = seed * 3, c = seed ^ 0x55, d = seed - 7,
+      e = seed * seed, f = seed + 11, g = seed << 2, h = seed / 3 + 5;
+  return (a + b + 100) + a + b * 2 + c * 3 + d * 5 + e * 7 + f * 11 + g * 13 +
+         h * 17;
+}
+
+int main(void)
+{
+  int ret = 0;
+  sigemptyset(&guarded);
+  sigaddset(&guarded, SIGNAL_TO_USE);
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(&guarded);
+  CHECK(handlers != WG14_SIGNALS_NULLPTR);
+
+#if WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT && !defined(_WIN32)
+  SECTION("the compact guarded frame fits in two cache lines");
+  CHECK(sizeof(struct WG14_SIGNALS_PREFIX(
+        sig_global_state_tss_state_per_frame_t)) <= 128);
+#endif
+
+  SECTION("recovery is into the guard, with the raise's siginfo");
+  {
+    recovered_signo = 0;
+    const value_t r = guard_raise(5);
+    CHECK(r.int_value == 105);
+    CHECK(recovered_signo == SIGNAL_TO_USE);
+    CHECK(recovered_value == 5);
+  }
+
+  SECTION("recovery is into the inner of two guards");
+  {
+    recovered_value = 0;
+    outer_recovered = 0;
+    const value_t r = WG14_SIGNALS_PREFIX(sigguarded)(
+    &guarded, guard_raise_func, outer_recovery_func, recover_decider,
+    make_value(20));
+    CHECK(r.int_value == 121);
+    CHECK(recovered_value == 20);
+    CHECK(!outer_recovered);
+  }
+
+#ifndef _WIN32
+  SECTION("recovery skips an inner guard without a recovery function");
+  {
+    recovered_value = 0;
+    const value_t r = WG14_SIGNALS_PREFIX(sigguarded)(
+    &guarded, unrecoverable_inner_func, recovery_func, recover_decider,
+    make_value(30));
+    CHECK(r.int_value == 130);
+    CHECK(recovered_value == 30);
+  }
+#endif
+
+  SECTION("a recovery may guard and recover itself");
+  {
+    nested_ok = 0;
+    const value_t r = WG14_SIGNALS_PREFIX(sigguarded)(
+    &guarded, guarding_recovery_outer_func, guarding_recovery_func,
+    recover_decider, make_value(40));
+    CHECK(r.int_value == 41);
+    CHECK(nested_ok);
+  }
+
+  SECTION("values in callee-saved registers survive recovery");
+  for(int seed = 1; seed < 100; seed++)
+  {
+    CHECK(live_across_guard(seed) == live_expected(seed));
+  }
+
+  CHECK(WG14_SIGNALS_PREFIX(siguninstall)(handlers) == 0);
+  printf("recovery context checks passed (compact = %d)\n",
+         WG14_SIGNALS_COMPACT_RECOVERY_CONTEXT);
+  return ret;
+}
@@ -0,0 +1,178 @@
+// Feature-test-macro mirror of the library build (plans/ideas.md 2.2), see
+// raise_claim_cleanup_test.c.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <signal.h>
+
+// stdc_raise() skips the frame walk when the thread's union of frame masks
+// lacks the signal, and tests each frame's own mask rather than its sigset_t.
+// With a dozen nested guards, check that a raise reaches exactly the frames
+// guarding its signal, including a signal above 63 sharing the top mask bit
+// where NSIG allows one, that the union is restored as guards return,
+// abandon and resume, and that it is back to zero once they all have. And
+// that the mask read straight out of this C library's sigset_t agrees with
+// sigismember(). White-box: header-only mode exposes the per-thread state.
+// POSIX-only, the Windows frames are SEH filters without masks.
+
+#define DEPTH 12
+
+static int ret;
+
+#ifndef _WIN32
+static sigset_t outer_set, inner_set;
+static int outer_calls, inner_calls;
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+outer_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  outer_calls++;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+inner_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  inner_calls++;
+  if(inner_calls == 1)
+  {
+    // Abandoning pops this frame and its bits, resuming pushes them back.
+    struct WG14_SIGNALS_PREFIX(sig_global_state_tss_state_t) *tss =
+    WG14_SIGNALS_PREFIX(sig_global_tss_state)();
+    const uint64_t before = tss->guarded_mask;
+    WG14_SIGNALS_PREFIX(sigdecider_abandon)(rsi);
+    CHECK(tss->guarded_mask == rsi->internal_local_decider->outer_mask);
+    WG14_SIGNALS_PREFIX(sigdecider_abandon_resume)(rsi);
+    CHECK(tss->guarded_mask == before);
+  }
+  return WG14_SIGNALS_PREFIX(sig_decision_next_decider);
+}
+
+static int raise_counting(int signo, int *outer, int *inner)
+{
+  outer_calls = inner_calls = 0;
+  const int claimed = WG14_SIGNALS_PREFIX(stdc_raise)(
+  signo, WG14_SIGNALS_NULLPTR, WG14_SIGNALS_NULLPTR);
+  *outer = outer_calls;
+  *inner = inner_calls;
+  return claimed;
+}
+
+// The frame mask of `signals` by testing each signal.
+static uint64_t slow_mask_of(const sigset_t *signals)
+{
+  uint64_t mask = 0;
+  for(int signo = 1; signo < NSIG; signo++)
+  {
+    if(sigismember(signals, signo) == 1)
+    {
+      mask |= WG14_SIGNALS_PREFIX(frame_mask_bit)(signo);
+    }
+  }
+  return mask;
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+innermost(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  int outer, inner;
+  SECTION("a raise reaches exactly the frames guarding its signal");
+  CHECK(raise_counting(SIGUSR1, &outer, &inner));
+  CHECK(outer == 1 && inner == 0);
+  CHECK(!raise_counting(SIGUSR2, &outer, &inner));
+  CHECK(outer == 0 && inner == DEPTH - 1);
+  CHECK(!raise_counting(SIGALRM, &outer, &inner));
+  CHECK(outer == 0 && inner == 0);
+#ifdef SIGRTMAX
+  SECTION("signals sharing the top mask bit are told apart");
+  if(SIGRTMAX >= 64)
+  {
+    CHECK(raise_counting(SIGRTMAX, &outer, &inner));
+    CHECK(outer == 1 && inner == 0);
+  }
+  CHECK(!raise_counting(SIGRTMAX - 1, &outer, &inner));
+  CHECK(outer == 0 && inner == 0);
+#endif
+  return value;
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+nest(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  if(++value.int_value == DEPTH)
+  {
+    return innermost(value);
+  }
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) r =
+  WG14_SIGNALS_PREFIX(sigguarded)(&inner_set, nest, WG14_SIGNALS_NULLPTR,
+                                  inner_decider, value);
+  // Popping the guard took its bits out of the union again.
+  if(value.int_value == 1)
+  {
+    int outer, inner;
+    CHECK(!raise_counting(SIGUSR2, &outer, &inner));
+    CHECK(outer == 0 && inner == 0);
+  }
+  return r;
+}
+#endif
+
+int main(void)
+{
+  ret = 0;
+#ifndef _WIN32
+  sigemptyset(&outer_set);
+  sigaddset(&outer_set, SIGUSR1);
+#ifdef SIGRTMAX
+  sigaddset(&outer_set, SIGRTMAX);
+#endif
+  sigemptyset(&inner_set);
+  sigaddset(&inner_set, SIGUSR2);
+
+  SECTION("the mask read from a sigset_t agrees with sigismember()");
+  {
+    sigset_t set;
+    sigemptyset(&set);
+    CHECK(WG14_SIGNALS_PREFIX(frame_mask_of)(&set) == 0);
+    for(int signo = 1; signo < NSIG; signo++)
+    {
+      sigemptyset(&set);
+      if(sigaddset(&set, signo) == 0)
+      {
+        CHECK(WG14_SIGNALS_PREFIX(frame_mask_of)(&set) == slow_mask_of(&set));
+      }
+    }
+    sigfillset(&set);
+    CHECK(WG14_SIGNALS_PREFIX(frame_mask_of)(&set) == slow_mask_of(&set));
+    CHECK(WG14_SIGNALS_PREFIX(frame_mask_of)(&outer_set) ==
+          slow_mask_of(&outer_set));
+  }
+
+  // Set up the per-thread state.
+  (void) WG14_SIGNALS_PREFIX(stdc_raise)(0, WG14_SIGNALS_NULLPTR,
+                                         WG14_SIGNALS_NULLPTR);
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  value.int_value = 0;
+  value = WG14_SIGNALS_PREFIX(sigguarded)(
+  &outer_set, nest, WG14_SIGNALS_NULLPTR, outer_decider, value);
+  CHECK(value.int_value == DEPTH);
+
+  SECTION("the union is empty once every guard has returned");
+  CHECK(WG14_SIGNALS_PREFIX(sig_global_tss_state)()->guarded_mask == 0);
+  int outer, inner;
+  CHECK(!raise_counting(SIGUSR1, &outer, &inner));
+  CHECK(outer == 0 && inner == 0);
+#endif
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
@@ -0,0 +1,231 @@
+// Feature-test-macro mirror of the library build (plans/ideas.md 2.2), see
+// raise_claim_cleanup_test.c: WG14_SIGNALS_UCONTEXT_PC needs REG_RIP on x86
+// Linux.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Table driven guarded regions: a raise whose context's instruction address
+// is within a registered region guarding the signal resumes at the region's
+// landing pad, before any sigguarded() frame is consulted. Check the
+// argument validation, the lookup with hand made contexts, and a real fault:
+// a load from an inaccessible page within an assembler region, whose landing
+// pad returns -1 instead, as an operating system kernel's exception table
+// would. The non-faulting load is a plain load instruction.
+
+#if defined(__GNUC__) && defined(__linux__) && !defined(__FILC__) &&          \
+(defined(__x86_64__) || defined(__aarch64__))
+#define HAVE_PROBE_LOAD 1
+// int probe_load(const int *p): returns *p, or -1 if reading it faulted.
+#if defined(__x86_64__)
+__asm__(".text\n"
+        ".globl probe_load\n"
+        ".type probe_load, @function\n"
+        "probe_load:\n"
+        "probe_load_begin:\n"
+        "  movl (%rdi), %eax\n"
+        "probe_load_end:\n"
+        "  ret\n"
+        "probe_load_fault:\n"
+        "  movl $-1, %eax\n"
+        "  ret\n"
+        ".size probe_load, .-probe_load\n"
+        ".globl probe_load_begin, probe_load_end, probe_load_fault\n");
+#else
+__asm__(".text\n"
+        ".globl probe_load\n"
+        ".type probe_load, %function\n"
+        "probe_load:\n"
+        "probe_load_begin:\n"
+        "  ldr w0, [x0]\n"
+        "probe_load_end:\n"
+        "  ret\n"
+        "probe_load_fault:\n"
+        "  mov w0, #-1\n"
+        "  ret\n"
+        ".size probe_load, .-probe_load\n"
+        ".globl probe_load_begin, probe_load_end, probe_load_fault\n");
+#endif
+extern int probe_load(const int *p);
+extern const char probe_load_begin[], probe_load_end[], probe_load_fault[];
+#endif
+
+#ifdef WG14_SIGNALS_UCONTEXT_PC
+static char code[64];
+static int frame_decider_calls;
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+frame_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  frame_decider_calls++;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+// Raise signo with a context interrupted at `pc`, returning where it resumes.
+static uintptr_t raise_at(int signo, uintptr_t pc, bool *claimed)
+{
+  WG14_SIGNALS_PREFIX(stdc_siginfo_context_t) uc;
+  memset(&uc, 0, sizeof(uc));
+#ifdef __APPLE__
+  struct __darwin_mcontext64 mc;
+  memset(&mc, 0, sizeof(mc));
+  uc.uc_mcontext = &mc;
+#endif
+  WG14_SIGNALS_UCONTEXT_PC(&uc) = pc;
+  *claimed = WG14_SIGNALS_PREFIX(stdc_raise)(signo, WG14_SIGNALS_NULLPTR, &uc);
+  return (uintptr_t) WG14_SIGNALS_UCONTEXT_PC(&uc);
+}
+
+static union WG14_SIGNALS_PREFIX(stdc_siginfo_value)
+raise_in_frame(union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value)
+{
+  bool claimed = false;
+  const uintptr_t resumed = raise_at(SIGUSR1, (uintptr_t) &code[8], &claimed);
+  value.int_value = claimed ? (intptr_t) resumed : 0;
+  return value;
+}
+#endif
+
+int main(void)
+{
+  int ret = 0;
+#ifdef WG14_SIGNALS_UCONTEXT_PC
+  sigset_t usr1;
+  sigemptyset(&usr1);
+  sigaddset(&usr1, SIGUSR1);
+  struct WG14_SIGNALS_PREFIX(sigguarded_region) region[2] = {
+  {&code[0], &code[16], &code[48]}, {&code[16], &code[32], &code[56]}};
+
+  SECTION("invalid registrations are rejected");
+  {
+    CHECK(WG14_SIGNALS_NULLPTR ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_register)(
+          WG14_SIGNALS_NULLPTR, region, 1));
+    CHECK(errno == EINVAL);
+    CHECK(WG14_SIGNALS_NULLPTR ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&usr1, region, 0));
+    CHECK(errno == EINVAL);
+    struct WG14_SIGNALS_PREFIX(sigguarded_region) empty = {
+    &code[4], &code[4], &code[48]};
+    CHECK(WG14_SIGNALS_NULLPTR ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&usr1, &empty, 1));
+    CHECK(errno == EINVAL);
+    CHECK(-1 ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(
+          WG14_SIGNALS_NULLPTR));
+  }
+
+  SECTION("a raise within a region resumes at its landing pad");
+  void *reg =
+  WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&usr1, region, 2);
+  CHECK(reg != WG14_SIGNALS_NULLPTR);
+  {
+    bool claimed = false;
+    CHECK(raise_at(SIGUSR1, (uintptr_t) &code[0], &claimed) ==
+          (uintptr_t) &code[48]);
+    CHECK(claimed);
+    CHECK(raise_at(SIGUSR1, (uintptr_t) &code[31], &claimed) ==
+          (uintptr_t) &code[56]);
+    CHECK(claimed);
+    // Outside the regions, or not a guarded signal.
+    CHECK(raise_at(SIGUSR1, (uintptr_t) &code[32], &claimed) ==
+          (uintptr_t) &code[32]);
+    CHECK(!claimed);
+    CHECK(raise_at(SIGUSR2, (uintptr_t) &code[8], &claimed) ==
+          (uintptr_t) &code[8]);
+    CHECK(!claimed);
+    // A region overlapping a registered one.
+    struct WG14_SIGNALS_PREFIX(sigguarded_region) overlapping = {
+    &code[24], &code[40], &code[48]};
+    CHECK(WG14_SIGNALS_NULLPTR ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&usr1,
+                                                           &overlapping, 1));
+    CHECK(errno == EINVAL);
+  }
+
+  SECTION("a region is consulted before the thread's guards");
+  {
+    frame_decider_calls = 0;
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    value.int_value = 0;
+    value = WG14_SIGNALS_PREFIX(sigguarded)(
+    &usr1, raise_in_frame, WG14_SIGNALS_NULLPTR, frame_decider, value);
+    CHECK(value.int_value == (intptr_t) &code[48]);
+    CHECK(frame_decider_calls == 0);
+  }
+
+#ifdef HAVE_PROBE_LOAD
+  SECTION("a faulting load in a region resumes at its landing pad");
+  {
+    sigset_t faults;
+    sigemptyset(&faults);
+    sigaddset(&faults, SIGSEGV);
+    sigaddset(&faults, SIGBUS);
+    void *handlers = WG14_SIGNALS_PREFIX(siginstall)(&faults);
+    CHECK(handlers != WG14_SIGNALS_NULLPTR);
+    struct WG14_SIGNALS_PREFIX(sigguarded_region) load = {
+    probe_load_begin, probe_load_end, probe_load_fault};
+    void *loadreg =
+    WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&faults, &load, 1);
+    CHECK(loadreg != WG14_SIGNALS_NULLPTR);
+    const long pagesize = sysconf(_SC_PAGESIZE);
+    void *page = mmap(WG14_SIGNALS_NULLPTR, (size_t) pagesize, PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(page != MAP_FAILED);
+    const int readable = 78;
+    for(int n = 0; n < 100; n++)
+    {
+      CHECK(probe_load(&readable) == 78);
+      CHECK(probe_load((const int *) page) == -1);
+    }
+    munmap(page, (size_t) pagesize);
+    CHECK(0 == WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(loadreg));
+    CHECK(0 == WG14_SIGNALS_PREFIX(siguninstall)(handlers));
+  }
+#endif
+
+  SECTION("a deregistered region no longer redirects");
+  {
+    CHECK(0 == WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(reg));
+    bool claimed = true;
+    CHECK(raise_at(SIGUSR1, (uintptr_t) &code[0], &claimed) ==
+          (uintptr_t) &code[0]);
+    CHECK(!claimed);
+    // Deregistering it again is refused rather than freeing it twice.
+    errno = 0;
+    CHECK(-1 == WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(reg));
+    CHECK(errno == EINVAL);
+  }
+#else
+  SECTION("regions are unsupported without a known context layout");
+  {
+    sigset_t set;
+    sigemptyset(&set);
+    struct WG14_SIGNALS_PREFIX(sigguarded_region) region = {&ret, &ret + 1,
+                                                            &ret};
+    CHECK(WG14_SIGNALS_NULLPTR ==
+          WG14_SIGNALS_PREFIX(sigguarded_regions_register)(&set, &region, 1));
+    CHECK(errno == ENOTSUP);
+    CHECK(-1 == WG14_SIGNALS_PREFIX(sigguarded_regions_deregister)(&region));
+    CHECK(errno == EINVAL);
+  }
+#endif
+  printf("Exiting main with result %d ...\n", ret);
+  return ret;
+}
@@ -8,6 +8,9 @@
 #endif
 
 #define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+// Containers come from the heap, where the calloc interposer below can fail
+// them, rather than from their slab pool.
+#define WG14_SIGNALS_SIGHANDLER_INFO_POOL_CAPACITY 0
 
 #include "test_common.h"
 
@@ -18,9 +21,10 @@
 // so no handler is left installed with no handle to uninstall it and a
 // subsequent siginstall does not double-count.
 //
-// install_sighandler() fails deterministically when its per-signal
-// sighandler_info allocation fails, so this test links with --wrap=calloc and
-// fails the sighandler_info-sized calloc for a chosen later signal. The
+// install_sighandlers() fails deterministically when one of its preallocated
+// per-signal sighandler_info allocations fails, so this test links with
+// --wrap=calloc and fails the sighandler_info-sized calloc for a chosen later
+// signal. The
 // header-only build compiles the .ipp into this TU, so the interposer sees the
 // .ipp's calloc calls and can size-match the struct.
 #ifndef _WIN32
@@ -65,8 +69,8 @@ static int whitebox_partial_install_rolls_back(void)
 
   sigset_t guarded;
   sigemptyset(&guarded);
-  // Two signals: the first installs successfully, the second's calloc fails,
-  // and siginstall must then uninstall the first before returning NULL.
+  // Two signals: the first's calloc succeeds, the second's fails, and
+  // siginstall must then return NULL with neither signal installed.
   sigaddset(&guarded, SIGUSR1);
   sigaddset(&guarded, SIGUSR2);
   errno = 0;
@@ -0,0 +1,107 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <string.h>
+
+// stdc_raise() first consults two lock-free bitmasks in the global state: the
+// signals with a handler installed, and the signals with at least one global
+// decider. White-box check (header-only mode makes the internal state
+// reachable from this TU) that the masks track install, decider create and
+// destroy, and uninstall, and that a raise of a signal installed without any
+// decider still hands off to the previously installed handler.
+
+#ifdef _WIN32
+#define SIGNAL_TO_USE SIGFPE
+#else
+#define SIGNAL_TO_USE SIGUSR1
+#endif
+
+static int previous_handler_calls = 0;
+static int decider_calls = 0;
+
+#ifndef _WIN32
+static void previous_handler(int signo)
+{
+  (void) signo;
+  previous_handler_calls++;
+}
+#endif
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+claiming_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  decider_calls++;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+  WG14_SIGNALS_PREFIX(sig_global_state)();
+#ifndef _WIN32
+  struct sigaction sa, old;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = previous_handler;
+  CHECK(0 == sigaction(SIGNAL_TO_USE, &sa, &old));
+#endif
+  sigset_t g;
+  sigemptyset(&g);
+  sigaddset(&g, SIGNAL_TO_USE);
+  CHECK(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals,
+                                            SIGNAL_TO_USE));
+  // Not installed: the raise reports no decider without doing anything.
+  CHECK(!WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                         WG14_SIGNALS_NULLPTR));
+
+  void *handlers = WG14_SIGNALS_PREFIX(siginstall)(&g);
+  if(handlers == WG14_SIGNALS_NULLPTR)
+  {
+    fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+    return 1;
+  }
+  CHECK(WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals,
+                                           SIGNAL_TO_USE));
+  CHECK(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->decider_signals,
+                                            SIGNAL_TO_USE));
+#ifndef _WIN32
+  // Installed without a decider: straight to the previous handler.
+  CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                        WG14_SIGNALS_NULLPTR));
+  CHECK(previous_handler_calls == 1);
+#endif
+
+  union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+  value.int_value = 0;
+  void *decider = WG14_SIGNALS_PREFIX(signal_decider_create)(
+  &g, false, claiming_decider, value);
+  CHECK(decider != WG14_SIGNALS_NULLPTR);
+  CHECK(WG14_SIGNALS_PREFIX(sig_mask_test)(&state->decider_signals,
+                                           SIGNAL_TO_USE));
+  CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                        WG14_SIGNALS_NULLPTR));
+  CHECK(decider_calls == 1);
+  CHECK(previous_handler_calls <= 1);
+
+  CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(decider));
+  CHECK(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->decider_signals,
+                                            SIGNAL_TO_USE));
+  CHECK(WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals,
+                                           SIGNAL_TO_USE));
+
+  CHECK(0 == WG14_SIGNALS_PREFIX(siguninstall)(handlers));
+  CHECK(!WG14_SIGNALS_PREFIX(sig_mask_test)(&state->installed_signals,
+                                            SIGNAL_TO_USE));
+#ifndef _WIN32
+  CHECK(0 == sigaction(SIGNAL_TO_USE, &old, WG14_SIGNALS_NULLPTR));
+#endif
+  printf("signal mask fast path checks passed\n");
+  return ret;
+}
@@ -16,13 +16,13 @@
 // outright). When the decider returns without claiming the signal, the raise
 // re-acquires the lock, its node refcount reaches zero and it re-accesses the
 // freed container's global_handler/deferred_frees list heads -> use-after-free.
-// The raise holds a reference on the container across the unlocked decider call
-// so the container survives until the raise releases it.
+// The raise's read-side announcement keeps the retired container and node
+// from being reclaimed until the raise has left the decider dispatch.
 
 #if defined(_WIN32)
 // The concurrent raise-vs-uninstall scenario is exercised on POSIX here; the
 // Windows vectored-handler path (analysis.md W4/2.15) uses the identical
-// refcount protocol but cannot be validated on this host.
+// reclamation protocol but cannot be validated on this host.
 int main(void)
 {
   return 0;
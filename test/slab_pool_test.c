@@ -0,0 +1,178 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/thrd_signal_handle.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <string.h>
+
+// The registration paths allocate their containers, single signal decider
+// handles and small snapshots from lock-free slab pools. White-box check
+// (header-only mode makes the internal pools reachable from this TU) that a
+// pool hands out distinct, aligned, zeroed slots up to its capacity, rejects
+// foreign pointers on free, survives concurrent churn without ever handing a
+// slot to two owners, and that decider handles really come from their pool.
+
+#define CAPACITY 8
+#define STRIDE WG14_SIGNALS_POOL_STRIDE(100)
+#define THREADS 4
+#define ITERATIONS 100000
+
+#ifdef _WIN32
+#define SIGNAL_TO_USE SIGFPE
+#else
+#define SIGNAL_TO_USE SIGUSR1
+#endif
+
+static struct WG14_SIGNALS_PREFIX(sig_pool_t) pool;
+static atomic_uint owners[CAPACITY];
+static atomic_int failures;
+
+static int churn(void *arg)
+{
+  (void) arg;
+  for(int n = 0; n < ITERATIONS; n++)
+  {
+    char *p = (char *) WG14_SIGNALS_PREFIX(sig_pool_alloc)(&pool, STRIDE,
+                                                           CAPACITY);
+    if(p == WG14_SIGNALS_NULLPTR)
+    {
+      continue;
+    }
+    const uintptr_t slab =
+    atomic_load_explicit(&pool.slab, memory_order_relaxed);
+    const size_t idx = ((uintptr_t) p - slab) / STRIDE;
+    unsigned expected = 0;
+    if(!atomic_compare_exchange_strong(&owners[idx], &expected, 1) ||
+       p[0] != 0)
+    {
+      atomic_fetch_add(&failures, 1);
+    }
+    p[0] = 1;
+    p[0] = 0;
+    atomic_store(&owners[idx], 0);
+    if(!WG14_SIGNALS_PREFIX(sig_pool_free)(&pool, STRIDE, CAPACITY, p))
+    {
+      atomic_fetch_add(&failures, 1);
+    }
+  }
+  return 0;
+}
+
+static enum WG14_SIGNALS_PREFIX(sig_decision)
+claiming_decider(struct WG14_SIGNALS_PREFIX(stdc_siginfo) * rsi)
+{
+  (void) rsi;
+  return WG14_SIGNALS_PREFIX(sig_decision_resume_execution);
+}
+
+int main(void)
+{
+  int ret = 0;
+  SECTION("slots are distinct, aligned, zeroed and bounded");
+  {
+    void *slots[CAPACITY];
+    for(int n = 0; n < CAPACITY; n++)
+    {
+      slots[n] = WG14_SIGNALS_PREFIX(sig_pool_alloc)(&pool, STRIDE, CAPACITY);
+      CHECK(slots[n] != WG14_SIGNALS_NULLPTR);
+      if(slots[n] == WG14_SIGNALS_NULLPTR)
+      {
+        return ret;
+      }
+      CHECK(((uintptr_t) slots[n] & (WG14_SIGNALS_POOL_ALIGNMENT - 1)) == 0);
+      for(int m = 0; m < n; m++)
+      {
+        CHECK(slots[m] != slots[n]);
+      }
+      memset(slots[n], 0xff, STRIDE);
+    }
+    // Exhausted.
+    CHECK(WG14_SIGNALS_PREFIX(sig_pool_alloc)(&pool, STRIDE, CAPACITY) ==
+          WG14_SIGNALS_NULLPTR);
+    int foreign = 0;
+    CHECK(
+    !WG14_SIGNALS_PREFIX(sig_pool_free)(&pool, STRIDE, CAPACITY, &foreign));
+    CHECK(WG14_SIGNALS_PREFIX(sig_pool_free)(&pool, STRIDE, CAPACITY,
+                                             slots[3]));
+    unsigned char *p = (unsigned char *) WG14_SIGNALS_PREFIX(sig_pool_alloc)(
+    &pool, STRIDE, CAPACITY);
+    CHECK(p == (unsigned char *) slots[3]);
+    if(p != WG14_SIGNALS_NULLPTR)
+    {
+      CHECK(p[0] == 0 && p[STRIDE - 1] == 0);
+    }
+    for(int n = 0; n < CAPACITY; n++)
+    {
+      CHECK(WG14_SIGNALS_PREFIX(sig_pool_free)(&pool, STRIDE, CAPACITY,
+                                               slots[n]));
+    }
+    // A disabled pool never hands out anything.
+    struct WG14_SIGNALS_PREFIX(sig_pool_t) disabled;
+    memset(&disabled, 0, sizeof(disabled));
+    CHECK(WG14_SIGNALS_PREFIX(sig_pool_alloc)(&disabled, STRIDE, 0) ==
+          WG14_SIGNALS_NULLPTR);
+  }
+
+  SECTION("concurrent churn never hands a slot to two owners");
+  {
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], churn, WG14_SIGNALS_NULLPTR));
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 0;
+      thrd_join(threads[n], &res);
+    }
+    CHECK(atomic_load(&failures) == 0);
+    // Every slot is back on the free list.
+    void *slots[CAPACITY];
+    for(int n = 0; n < CAPACITY; n++)
+    {
+      slots[n] = WG14_SIGNALS_PREFIX(sig_pool_alloc)(&pool, STRIDE, CAPACITY);
+      CHECK(slots[n] != WG14_SIGNALS_NULLPTR);
+    }
+    CHECK(WG14_SIGNALS_PREFIX(sig_pool_alloc)(&pool, STRIDE, CAPACITY) ==
+          WG14_SIGNALS_NULLPTR);
+  }
+
+  SECTION("single signal decider handles come from their pool");
+  {
+    struct WG14_SIGNALS_PREFIX(sig_global_state_t) *state =
+    WG14_SIGNALS_PREFIX(sig_global_state)();
+    sigset_t g;
+    sigemptyset(&g);
+    sigaddset(&g, SIGNAL_TO_USE);
+    void *handlers = WG14_SIGNALS_PREFIX(siginstall)(&g);
+    if(handlers == WG14_SIGNALS_NULLPTR)
+    {
+      fprintf(stderr, "FATAL: siginstall() failed with %s\n", strerror(errno));
+      return 1;
+    }
+    union WG14_SIGNALS_PREFIX(stdc_siginfo_value) value;
+    value.int_value = 0;
+    void *decider = WG14_SIGNALS_PREFIX(signal_decider_create)(
+    &g, false, claiming_decider, value);
+    CHECK(decider != WG14_SIGNALS_NULLPTR);
+    const uintptr_t slab =
+    atomic_load_explicit(&state->decider_pool.slab, memory_order_relaxed);
+    CHECK(slab != 0);
+    CHECK((uintptr_t) decider >= slab &&
+          (uintptr_t) decider <
+          slab + WG14_SIGNALS_DECIDER_POOL_CAPACITY *
+                 WG14_SIGNALS_DECIDER_POOL_STRIDE);
+    CHECK(WG14_SIGNALS_PREFIX(stdc_raise)(SIGNAL_TO_USE, WG14_SIGNALS_NULLPTR,
+                                          WG14_SIGNALS_NULLPTR));
+    CHECK(0 == WG14_SIGNALS_PREFIX(signal_decider_destroy)(decider));
+    CHECK(0 == WG14_SIGNALS_PREFIX(siguninstall)(handlers));
+  }
+  printf("slab pool checks passed\n");
+  return ret;
+}
@@ -24,22 +24,22 @@
 
 // White-box regression test for plans/analysis.md TIDR: the
 // tss_async_signal_safe map is keyed by a composite of a per-thread generation
-// (high 32 bits) and the kernel thread id (low 32 bits). A thread that exits
-// without running its exit-time deinit (abnormal termination, a cancelled
-// thread_atexit registration, or the Darwin pthread-key fallback dropping every
-// callback) leaves its entry in the map; a later thread that reuses the same
-// kernel TID draws a different generation and so must NOT observe or inherit
-// that stale entry -- it gets NULL from get() before initialising and a fresh
-// value from thread_init().
+// (high 32 bits) and one plus a dense, recycled thread index (low 32 bits). A
+// thread that exits without running its exit-time deinit (abnormal
+// termination, a cancelled thread_atexit registration, or the Darwin
+// pthread-key fallback dropping every callback) leaves its entry in the map; a
+// later thread that reuses the same index draws a different generation and so
+// must NOT observe or inherit that stale entry -- it gets NULL from get()
+// before initialising and a fresh value from thread_init().
 //
 // The stale entry is manufactured white-box: header-only mode compiles
 // tss_async_signal_safe.c.ipp into this TU, so the internal map, the shared
 // per-thread generation cache and the composite-key helper are reachable. The
 // current thread's generation cache is pinned to an "old" generation and an
-// entry for (old_generation, current_tid) is inserted directly -- the state a
-// previous incarnation of this TID that never ran its deinit would leave. The
+// entry for (old_generation, current_index) is inserted directly -- the state
+// a previous holder of this index that never ran its deinit would leave. The
 // generation cache is then moved to a "new" generation, the position a fresh
-// thread reusing this TID is in, and the map must miss the stale entry.
+// thread reusing this index is in, and the map must miss the stale entry.
 
 static int create_cb(void **dest)
 {
@@ -79,9 +79,9 @@ static int test_generation_assignment(void)
   return ret;
 }
 
-// The core TIDR regression: a stale entry for this kernel tid under an old
-// generation must be invisible to (and never reused by) a later incarnation of
-// the tid.
+// The core TIDR regression: a stale entry for this thread index under an old
+// generation must be invisible to (and never reused by) a later holder of the
+// index.
 static int test_stale_entry_not_observed(void)
 {
   int ret = 0;
@@ -92,33 +92,29 @@ static int test_stale_entry_not_observed(void)
   struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
   (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) tls;
 
-  // Manufacture the previous incarnation's entry: generation 1 keyed with this
-  // thread's kernel tid, simulating a thread that exited without running its
+  // Manufacture the previous holder's entry: generation 1 keyed with this
+  // thread's index, simulating a thread that exited without running its
   // deinit (the entry is never erased, and the value is never destroyed until
   // destroy() sweeps the map).
+  CHECK(0 == WG14_SIGNALS_PREFIX(tss_thread_index_init)());
   const uint64_t stale_key = WG14_SIGNALS_PREFIX(my_current_thread_id)();
   unsigned *stale_val = (unsigned *) malloc(sizeof(unsigned));
   CHECK(stale_val != WG14_SIGNALS_NULLPTR);
   *stale_val = 7;
-  LOCK(mem->lock);
-  WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_itr)
-  it = WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
-  &mem->thread_id_to_tls_map, stale_key, stale_val);
-  CHECK(!WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_is_end)(it));
-  UNLOCK(mem->lock);
-
-  // Simulate the kernel reusing this tid for a new thread incarnation: the
-  // generation cache moves to a fresh generation. Pre-fix, the map was keyed
-  // by the bare kernel tid, so the new incarnation found (and reused) the
-  // stale entry; post-fix the composite keys differ.
+  CHECK(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
+  &mem->thread_id_to_tls_map, stale_key, stale_val));
+
+  // Simulate a new thread reusing this index: the generation cache moves to a
+  // fresh generation. Were the map keyed by the bare index, the new holder
+  // would find (and reuse) the stale entry; the composite keys differ.
   WG14_SIGNALS_PREFIX(tss_generation_cached) = 2;
   CHECK(WG14_SIGNALS_PREFIX(my_current_thread_id)() != stale_key);
 
-  // get() before initialisation must not observe the previous incarnation's
+  // get() before initialisation must not observe the previous holder's
   // value.
   CHECK(TSS_GET(tls) == WG14_SIGNALS_NULLPTR);
 
-  // thread_init() must create a fresh value for the new incarnation rather
+  // thread_init() must create a fresh value for the new holder rather
   // than silently reuse the stale one.
   CHECK(0 == TSS_THREAD_INIT(tls));
   unsigned *val = (unsigned *) TSS_GET(tls);
@@ -147,8 +143,8 @@ static int worker_thr(void *unused)
 }
 
 // Two threads' first uses must draw distinct generations from the shared
-// counter, so their map entries can never alias even when the kernel reuses a
-// tid between them.
+// counter, so their map entries can never alias even when the second reuses
+// the first's index.
 static int test_distinct_generations(void)
 {
   int ret = 0;
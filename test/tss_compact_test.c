@@ -0,0 +1,99 @@
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_STATS WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats_t)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+#define TSS_COMPACT WG14_SIGNALS_PREFIX(tss_async_signal_safe_compact)
+#define TSS_GET_STATS WG14_SIGNALS_PREFIX(tss_async_signal_safe_stats)
+
+// After a spike of threads registers with an instance and exits again, its
+// table must shrink back rather than keep its peak size, and compact() must
+// free whatever superseded tables are left, with stats() reporting it all.
+
+#define THREADS 64
+
+static TSS tls;
+static int value;
+static atomic_int arrived;
+
+static int create_cb(void **dest)
+{
+  *dest = &value;
+  return 0;
+}
+
+static int worker(void *arg)
+{
+  (void) arg;
+  if(TSS_THREAD_INIT(tls) != 0 || TSS_GET(tls) != &value)
+  {
+    return 1;
+  }
+  // Every thread is registered at once before any exits, which the main
+  // thread allows once it has looked.
+  atomic_fetch_add(&arrived, 1);
+  while(atomic_load(&arrived) <= THREADS)
+  {
+    thrd_yield();
+  }
+  return 0;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb};
+  CHECK(0 == TSS_CREATE(&tls, &attr));
+  CHECK(0 == TSS_THREAD_INIT(tls));
+  struct TSS_STATS initial, stats;
+  TSS_GET_STATS(tls, &initial);
+  CHECK(initial.threads == 1);
+  CHECK(initial.shrinks == 0 && initial.bytes_saved == 0);
+
+  thrd_t threads[THREADS];
+  for(int n = 0; n < THREADS; n++)
+  {
+    CHECK(thrd_success ==
+          thrd_create(&threads[n], worker, WG14_SIGNALS_NULLPTR));
+  }
+  while(atomic_load(&arrived) < THREADS)
+  {
+    thrd_yield();
+  }
+  struct TSS_STATS peak;
+  TSS_GET_STATS(tls, &peak);
+  CHECK(peak.threads == THREADS + 1);
+  CHECK(peak.capacity >= 2 * (THREADS + 1));
+  CHECK(peak.bytes > initial.bytes);
+  atomic_fetch_add(&arrived, 1);
+  for(int n = 0; n < THREADS; n++)
+  {
+    int res = 1;
+    thrd_join(threads[n], &res);
+    CHECK(res == 0);
+  }
+  TSS_GET_STATS(tls, &stats);
+  CHECK(stats.threads == 1);
+  // Shrunk back as the threads exited.
+  CHECK(stats.shrinks > 0);
+  CHECK(stats.capacity == initial.capacity);
+
+  CHECK(0 == TSS_COMPACT(tls));
+  TSS_GET_STATS(tls, &stats);
+  CHECK(stats.capacity == initial.capacity);
+  CHECK(stats.bytes == initial.bytes);
+  CHECK(stats.bytes_saved > 0);
+  CHECK(TSS_GET(tls) == &value);
+
+  CHECK(0 == TSS_DESTROY(tls));
+  printf("tss compact checks passed\n");
+  return ret;
+}
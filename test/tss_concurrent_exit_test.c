@@ -94,10 +94,10 @@ static int test_reinit_and_destroy_after_all_exited(void)
 }
 
 // Regression for plans/analysis.md 2.1: two threads sharing the same
-// tss_async_signal_safe exit at roughly the same time. The deinit count
-// decrement and the deinit_state free must serialise on mem->lock so that no
-// deinit frees the shared deinit_state while the other thread is still
-// decrementing it or reading state->val.
+// tss_async_signal_safe exit at roughly the same time. No deinit may free the
+// shared deinit_state while the other thread is still decrementing it or
+// reading state->val: only the last reference, which while the instance lives
+// is the instance's own, frees it.
 static int test_concurrent_exit(void)
 {
   int ret = 0;
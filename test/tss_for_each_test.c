@@ -0,0 +1,190 @@
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+#define TSS_FOR_EACH WG14_SIGNALS_PREFIX(tss_async_signal_safe_for_each)
+
+// tss_async_signal_safe_for_each() visits every registered thread's value.
+// Check that it visits each exactly once while those threads are alive, that
+// a nonzero return from the callback ends the visit, and that visiting
+// continuously while threads register, count and exit never sees a value
+// which has been destroyed (the values are heap allocated, so a sanitiser
+// build also catches a visit after free).
+
+#define THREADS 4
+#define CHURN_THREADS 200
+#define MAGIC 0x5eed5eedu
+
+struct counter_t
+{
+  atomic_uint magic;
+  atomic_ullong count;
+};
+
+static TSS tls;
+static atomic_int failures;
+static atomic_int arrived;
+static int wait_for;
+static atomic_int churning;
+
+static int create_cb(void **dest)
+{
+  struct counter_t *c = (struct counter_t *) malloc(sizeof(struct counter_t));
+  if(c == WG14_SIGNALS_NULLPTR)
+  {
+    return -1;
+  }
+  atomic_init(&c->magic, MAGIC);
+  atomic_init(&c->count, 0);
+  *dest = c;
+  return 0;
+}
+static int destroy_cb(void *v)
+{
+  struct counter_t *c = (struct counter_t *) v;
+  atomic_store(&c->magic, 0);
+  free(c);
+  return 0;
+}
+
+static int bump(void *arg)
+{
+  (void) arg;
+  if(TSS_THREAD_INIT(tls) != 0)
+  {
+    return 1;
+  }
+  struct counter_t *c = (struct counter_t *) TSS_GET(tls);
+  for(int n = 0; n < 100; n++)
+  {
+    atomic_store_explicit(
+    &c->count, atomic_load_explicit(&c->count, memory_order_relaxed) + 1,
+    memory_order_relaxed);
+  }
+  atomic_fetch_add(&arrived, 1);
+  while(atomic_load(&arrived) < wait_for)
+  {
+    thrd_yield();
+  }
+  return 0;
+}
+
+static int churn(void *arg)
+{
+  (void) arg;
+  for(int n = 0; n < CHURN_THREADS; n++)
+  {
+    thrd_t thr;
+    int res = 1;
+    if(thrd_create(&thr, bump, WG14_SIGNALS_NULLPTR) != thrd_success)
+    {
+      atomic_fetch_add(&failures, 1);
+      break;
+    }
+    thrd_join(thr, &res);
+    if(res != 0)
+    {
+      atomic_fetch_add(&failures, 1);
+    }
+  }
+  atomic_fetch_sub(&churning, 1);
+  return 0;
+}
+
+static int sum(void *value, void *arg)
+{
+  struct counter_t *c = (struct counter_t *) value;
+  if(atomic_load(&c->magic) != MAGIC)
+  {
+    atomic_fetch_add(&failures, 1);
+  }
+  *(unsigned long long *) arg += atomic_load(&c->count);
+  return 0;
+}
+
+static int stop_at_first(void *value, void *arg)
+{
+  (void) value;
+  ++*(int *) arg;
+  return 7;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb, .destroy = destroy_cb};
+  CHECK(0 == TSS_CREATE(&tls, &attr));
+
+  SECTION("every live thread's value is visited once");
+  {
+    unsigned long long total = 0;
+    CHECK(0 == TSS_FOR_EACH(tls, sum, &total));
+    CHECK(total == 0);
+    // The threads wait for one more arrival, this thread's, before exiting.
+    wait_for = THREADS + 1;
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], bump, WG14_SIGNALS_NULLPTR));
+    }
+    while(atomic_load(&arrived) < THREADS)
+    {
+      thrd_yield();
+    }
+    CHECK(0 == TSS_FOR_EACH(tls, sum, &total));
+    CHECK(total == THREADS * 100);
+    int visits = 0;
+    CHECK(7 == TSS_FOR_EACH(tls, stop_at_first, &visits));
+    CHECK(visits == 1);
+    atomic_fetch_add(&arrived, 1);
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 1;
+      thrd_join(threads[n], &res);
+      CHECK(res == 0);
+    }
+    wait_for = 0;
+    // The exited threads' values are gone.
+    total = 0;
+    CHECK(0 == TSS_FOR_EACH(tls, sum, &total));
+    CHECK(total == 0);
+  }
+
+  SECTION("visiting while threads come and go never sees a destroyed value");
+  {
+    atomic_store(&churning, THREADS);
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], churn, WG14_SIGNALS_NULLPTR));
+    }
+    while(atomic_load(&churning) > 0)
+    {
+      unsigned long long total = 0;
+      (void) TSS_FOR_EACH(tls, sum, &total);
+      CHECK(total <= THREADS * 100);
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 1;
+      thrd_join(threads[n], &res);
+    }
+    CHECK(atomic_load(&failures) == 0);
+  }
+
+  CHECK(0 == TSS_DESTROY(tls));
+  printf("tss for_each checks passed\n");
+  return ret;
+}
@@ -0,0 +1,160 @@
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT_MANY                                                   \
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_many)
+#define TSS_THREAD_INIT_ALL                                                    \
+  WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init_all)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+
+// thread_init_many() and thread_init_all() register a thread with many
+// instances at once. Check that every instance then has the thread's value,
+// that calling again creates nothing, that at thread exit every value is
+// destroyed, most recently initialised first, and that when one instance
+// fails the ones before it are still initialised and later destroyed.
+
+#define INSTANCES 20
+
+static TSS tls[INSTANCES];
+static int ids[INSTANCES];
+static atomic_int created;
+static int destroyed[INSTANCES];
+static atomic_int ndestroyed;
+static int failing = -1;
+
+static int create_cb(void **dest)
+{
+  // Instances are created in order, and each thread initialises them in
+  // order, so the count of creations so far identifies the instance.
+  const int id = atomic_fetch_add(&created, 1) % INSTANCES;
+  if(id == failing)
+  {
+    return -1;
+  }
+  *dest = &ids[id];
+  return 0;
+}
+static int destroy_cb(void *v)
+{
+  destroyed[atomic_fetch_add(&ndestroyed, 1)] = *(int *) v;
+  return 0;
+}
+
+static int check_values(int upto)
+{
+  for(int n = 0; n < INSTANCES; n++)
+  {
+    if(TSS_GET(tls[n]) != (n < upto ? &ids[n] : WG14_SIGNALS_NULLPTR))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int init_many(void *arg)
+{
+  (void) arg;
+  if(TSS_THREAD_INIT_MANY(tls, INSTANCES) != 0 || check_values(INSTANCES))
+  {
+    return 1;
+  }
+  // Already initialised, so nothing more is created.
+  const int before = atomic_load(&created);
+  if(TSS_THREAD_INIT_MANY(tls, INSTANCES) != 0 ||
+     atomic_load(&created) != before || check_values(INSTANCES))
+  {
+    return 1;
+  }
+  return 0;
+}
+
+static int init_all(void *arg)
+{
+  (void) arg;
+  return TSS_THREAD_INIT_ALL() != 0 || check_values(INSTANCES);
+}
+
+static int init_failing(void *arg)
+{
+  (void) arg;
+  return TSS_THREAD_INIT_MANY(tls, INSTANCES) == 0 || check_values(failing);
+}
+
+static int run(int (*func)(void *))
+{
+  thrd_t thr;
+  int res = 1;
+  atomic_store(&created, 0);
+  atomic_store(&ndestroyed, 0);
+  if(thrd_create(&thr, func, WG14_SIGNALS_NULLPTR) != thrd_success)
+  {
+    return 1;
+  }
+  thrd_join(thr, &res);
+  return res;
+}
+
+static int destroyed_in_reverse(int count)
+{
+  if(atomic_load(&ndestroyed) != count)
+  {
+    return 0;
+  }
+  for(int n = 0; n < count; n++)
+  {
+    if(destroyed[n] != count - 1 - n)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb, .destroy = destroy_cb};
+  for(int n = 0; n < INSTANCES; n++)
+  {
+    ids[n] = n;
+    CHECK(0 == TSS_CREATE(&tls[n], &attr));
+  }
+
+  SECTION("thread_init_many() initialises every instance once");
+  {
+    CHECK(run(init_many) == 0);
+    CHECK(atomic_load(&created) == INSTANCES);
+    CHECK(destroyed_in_reverse(INSTANCES));
+  }
+
+  SECTION("thread_init_all() initialises every instance");
+  {
+    CHECK(run(init_all) == 0);
+    CHECK(atomic_load(&created) == INSTANCES);
+    CHECK(destroyed_in_reverse(INSTANCES));
+  }
+
+  SECTION("a failure leaves the instances before it initialised");
+  {
+    failing = INSTANCES / 2;
+    CHECK(run(init_failing) == 0);
+    CHECK(destroyed_in_reverse(INSTANCES / 2));
+    failing = -1;
+  }
+
+  for(int n = 0; n < INSTANCES; n++)
+  {
+    CHECK(0 == TSS_DESTROY(tls[n]));
+  }
+  printf("tss init many checks passed\n");
+  return ret;
+}
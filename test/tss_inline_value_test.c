@@ -0,0 +1,172 @@
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+
+// With a nonzero value_size the library stores each thread's value inline.
+// Check that the values are zeroed, cache line aligned and distinct per
+// thread, that the create and destroy callbacks are optional and run in
+// place, that a thread's slot is reused after it exits, and that a fixed
+// capacity instance refuses a thread once every slot is in use.
+
+#define THREADS 4
+#define CACHE_LINE 64
+
+struct counter_t
+{
+  unsigned long long count;
+  unsigned initialised;
+};
+
+static TSS tls;
+static atomic_int failures;
+static atomic_int created, destroyed;
+static void *seen[THREADS];
+// How many threads must have their values at once before any may exit.
+static atomic_int arrived;
+static int wait_for;
+
+static int init_in_place(void **dest)
+{
+  struct counter_t *c = (struct counter_t *) *dest;
+  if(c->count != 0 || c->initialised != 0)
+  {
+    atomic_fetch_add(&failures, 1);
+  }
+  c->initialised = 1;
+  atomic_fetch_add(&created, 1);
+  return 0;
+}
+static int teardown(void *v)
+{
+  if(((struct counter_t *) v)->initialised != 1)
+  {
+    atomic_fetch_add(&failures, 1);
+  }
+  atomic_fetch_add(&destroyed, 1);
+  return 0;
+}
+
+static int bump(void *arg)
+{
+  const int me = (int) (intptr_t) arg;
+  if(TSS_THREAD_INIT(tls) != 0)
+  {
+    return 1;
+  }
+  struct counter_t *c = (struct counter_t *) TSS_GET(tls);
+  if(c == WG14_SIGNALS_NULLPTR || ((uintptr_t) c & (CACHE_LINE - 1)) != 0)
+  {
+    return 1;
+  }
+  for(int n = 0; n < 1000; n++)
+  {
+    c->count++;
+  }
+  if(me >= 0)
+  {
+    seen[me] = c;
+  }
+  atomic_fetch_add(&arrived, 1);
+  while(atomic_load(&arrived) < wait_for)
+  {
+    thrd_yield();
+  }
+  return c->count == 1000 ? 0 : 1;
+}
+
+static int run(int me)
+{
+  thrd_t thr;
+  int res = 1;
+  if(thrd_create(&thr, bump, (void *) (intptr_t) me) != thrd_success)
+  {
+    return 1;
+  }
+  thrd_join(thr, &res);
+  return res;
+}
+
+int main(void)
+{
+  int ret = 0;
+  SECTION("values are zeroed, aligned, distinct and initialised in place");
+  {
+    struct TSS_ATTR attr = {.create = init_in_place,
+                            .destroy = teardown,
+                            .value_size = sizeof(struct counter_t)};
+    CHECK(0 == TSS_CREATE(&tls, &attr));
+    wait_for = THREADS;
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], bump, (void *) (intptr_t) n));
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 1;
+      thrd_join(threads[n], &res);
+      CHECK(res == 0);
+    }
+    wait_for = 0;
+    for(int n = 0; n < THREADS; n++)
+    {
+      for(int m = 0; m < n; m++)
+      {
+        // Not on the same cache line.
+        const uintptr_t a = (uintptr_t) seen[n], b = (uintptr_t) seen[m];
+        CHECK((a > b ? a - b : b - a) >= CACHE_LINE);
+      }
+    }
+    CHECK(atomic_load(&created) == THREADS);
+    CHECK(atomic_load(&destroyed) == THREADS);
+    CHECK(atomic_load(&failures) == 0);
+    CHECK(0 == TSS_DESTROY(tls));
+  }
+
+  SECTION("the callbacks are optional");
+  {
+    struct TSS_ATTR attr = {.value_size = sizeof(struct counter_t),
+                            .value_alignment = 256};
+    CHECK(0 == TSS_CREATE(&tls, &attr));
+    CHECK(0 == TSS_THREAD_INIT(tls));
+    struct counter_t *c = (struct counter_t *) TSS_GET(tls);
+    CHECK(c != WG14_SIGNALS_NULLPTR);
+    if(c != WG14_SIGNALS_NULLPTR)
+    {
+      CHECK(((uintptr_t) c & 255) == 0);
+      CHECK(c->count == 0);
+    }
+    CHECK(run(-1) == 0);
+    CHECK(0 == TSS_DESTROY(tls));
+  }
+
+  SECTION("a fixed capacity instance reuses the slots of exited threads");
+  {
+    struct TSS_ATTR attr = {.max_threads = 1,
+                            .value_size = sizeof(struct counter_t)};
+    CHECK(0 == TSS_CREATE(&tls, &attr));
+    // One after the other, each exiting before the next starts.
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(run(n) == 0);
+      CHECK(seen[n] == seen[0]);
+    }
+    // While this thread holds the only slot, another thread is refused.
+    CHECK(0 == TSS_THREAD_INIT(tls));
+    CHECK(run(-1) != 0);
+    CHECK(0 == TSS_DESTROY(tls));
+  }
+  printf("tss inline value checks passed\n");
+  return ret;
+}
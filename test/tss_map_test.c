@@ -0,0 +1,272 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+// Small, so that the map grows and shrinks many times while the threads use
+// it.
+#define WG14_SIGNALS_TSS_MAP_INITIAL_CAPACITY 4
+#define WG14_SIGNALS_TSS_MAP_NEIGHBOURHOOD 4
+
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+
+#define MAP WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t)
+#define MAP_INIT WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_init)
+#define MAP_CLEANUP WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_cleanup)
+#define MAP_GET WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_get)
+#define MAP_INSERT WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)
+#define MAP_ERASE WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)
+#define MAP_ERASE_NEXT WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase_next)
+#define MAP_COMPACT WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_compact)
+
+// The tss_async_signal_safe thread id map is written without a lock and read
+// lock-free. White-box check (header-only mode makes the internal map
+// reachable from this TU) that concurrent threads inserting, looking up and
+// erasing their own keys, while the map grows and shrinks under them, always
+// find exactly their own values, that erased keys are gone, and that
+// erase_next() visits every remaining entry exactly once. That growth frees
+// the tables it superseded, unless a table user may still hold them, which
+// compaction then frees, and that erasing most keys shrinks the table. Then
+// that a fixed capacity map never grows: it places keys beyond their
+// neighbourhood instead, and refuses one more than it was made for.
+
+#define THREADS 8
+#define KEYS 64
+#define ROUNDS 200
+
+static MAP map;
+static atomic_int failures;
+static int values[THREADS][KEYS];
+
+// Keys are never zero, and each thread owns its own, as each thread owns its
+// generation|index key in the real map. The low halves are dense and distinct
+// like thread indices, so most keys sit in their home slot.
+static uint64_t key_of(int thread, int n)
+{
+  return ((uint64_t) (thread + 1) << 32) | (uint64_t) (thread * KEYS + n + 1);
+}
+
+static int worker(void *arg)
+{
+  const int me = (int) (intptr_t) arg;
+  for(int round = 0; round < ROUNDS; round++)
+  {
+    for(int n = 0; n < KEYS; n++)
+    {
+      if(!MAP_INSERT(&map, key_of(me, n), &values[me][n]))
+      {
+        atomic_fetch_add(&failures, 1);
+      }
+    }
+    for(int n = 0; n < KEYS; n++)
+    {
+      if(MAP_GET(&map, key_of(me, n)) != &values[me][n])
+      {
+        atomic_fetch_add(&failures, 1);
+      }
+    }
+    // Erase all but the last round's odd keys, which stay for erase_next().
+    for(int n = 0; n < KEYS; n++)
+    {
+      if(round == ROUNDS - 1 && (n & 1) != 0)
+      {
+        continue;
+      }
+      if(MAP_ERASE(&map, key_of(me, n)) != &values[me][n] ||
+         MAP_GET(&map, key_of(me, n)) != WG14_SIGNALS_NULLPTR)
+      {
+        atomic_fetch_add(&failures, 1);
+      }
+    }
+  }
+  return 0;
+}
+
+static WG14_SIGNALS_PREFIX(tss_async_signal_safe_t) tls;
+static atomic_int created;
+
+static int create_cb(void **dest)
+{
+  *dest = &values[0][atomic_fetch_add(&created, 1)];
+  return 0;
+}
+static int destroy_cb(void *v)
+{
+  (void) v;
+  return 0;
+}
+
+static int tss_worker(void *arg)
+{
+  (void) arg;
+  if(WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)(tls) != 0)
+  {
+    return 1;
+  }
+  return WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)(tls) !=
+         WG14_SIGNALS_NULLPTR
+         ? 0
+         : 1;
+}
+
+int main(void)
+{
+  int ret = 0;
+  SECTION("an empty map");
+  {
+    CHECK(MAP_INIT(&map, 0));
+    CHECK(MAP_GET(&map, key_of(0, 0)) == WG14_SIGNALS_NULLPTR);
+    CHECK(MAP_ERASE(&map, key_of(0, 0)) == WG14_SIGNALS_NULLPTR);
+    size_t pos = 0;
+    CHECK(MAP_ERASE_NEXT(&map, &pos) == WG14_SIGNALS_NULLPTR);
+  }
+
+  SECTION("concurrent insert, lookup and erase while the map resizes");
+  {
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], worker, (void *) (intptr_t) n));
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 0;
+      thrd_join(threads[n], &res);
+    }
+    CHECK(atomic_load(&failures) == 0);
+    const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load(&map.table);
+    CHECK(table->mask + 1 >= THREADS * KEYS / 2);
+    CHECK(map.shrinks > 0);
+  }
+
+  SECTION("erase_next() visits every remaining entry once");
+  {
+    static int seen[THREADS][KEYS];
+    size_t pos = 0, count = 0;
+    for(int *v = (int *) MAP_ERASE_NEXT(&map, &pos); v != WG14_SIGNALS_NULLPTR;
+        v = (int *) MAP_ERASE_NEXT(&map, &pos))
+    {
+      const size_t idx = (size_t) (v - &values[0][0]);
+      CHECK(idx < THREADS * KEYS && (idx & 1) != 0);
+      seen[idx / KEYS][idx % KEYS]++;
+      count++;
+    }
+    CHECK(count == THREADS * KEYS / 2);
+    for(int t = 0; t < THREADS; t++)
+    {
+      for(int n = 1; n < KEYS; n += 2)
+      {
+        CHECK(seen[t][n] == 1);
+        CHECK(MAP_GET(&map, key_of(t, n)) == WG14_SIGNALS_NULLPTR);
+      }
+    }
+    MAP_CLEANUP(&map);
+  }
+
+  SECTION("growth frees superseded tables unless a reader holds them");
+  {
+    CHECK(MAP_INIT(&map, 0));
+    CHECK(MAP_INSERT(&map, key_of(0, 0), &values[0][0]));
+    const size_t before = map.bytes_saved;
+    // A table user holds up freeing the tables superseded meanwhile.
+    bool announced;
+    (void) WG14_SIGNALS_PREFIX(thread_id_to_tls_map_pin)(&map, &announced);
+    for(int n = 1; n < KEYS / 2; n++)
+    {
+      CHECK(MAP_INSERT(&map, key_of(0, n), &values[0][n]));
+    }
+    const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+    (const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load(&map.table);
+    CHECK(table->prev != WG14_SIGNALS_NULLPTR);
+    CHECK(map.bytes_saved == before);
+    WG14_SIGNALS_PREFIX(thread_id_to_tls_map_unpin)(announced);
+    // Still needs its size, so only the superseded tables go.
+    MAP_COMPACT(&map);
+    CHECK(atomic_load(&map.table) == (uintptr_t) table);
+    CHECK(table->prev == WG14_SIGNALS_NULLPTR);
+    CHECK(map.bytes_saved > before);
+    // With no table user, growth frees what it supersedes at once.
+    const size_t saved = map.bytes_saved;
+    for(int n = KEYS / 2; n < KEYS; n++)
+    {
+      CHECK(MAP_INSERT(&map, key_of(0, n), &values[0][n]));
+    }
+    table = (const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load(&map.table);
+    const size_t capacity = table->mask + 1;
+    CHECK(capacity >= KEYS * 2);
+    CHECK(table->prev == WG14_SIGNALS_NULLPTR);
+    CHECK(map.bytes_saved > saved);
+    const size_t shrinks = map.shrinks;
+    for(int n = 2; n < KEYS; n++)
+    {
+      CHECK(MAP_ERASE(&map, key_of(0, n)) == &values[0][n]);
+    }
+    table = (const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *)
+    atomic_load(&map.table);
+    CHECK(map.shrinks > shrinks);
+    CHECK(table->mask + 1 < capacity);
+    CHECK(table->prev == WG14_SIGNALS_NULLPTR);
+    CHECK(MAP_GET(&map, key_of(0, 0)) == &values[0][0]);
+    CHECK(MAP_GET(&map, key_of(0, 1)) == &values[0][1]);
+    MAP_CLEANUP(&map);
+  }
+
+  SECTION("a fixed capacity map never grows");
+  {
+    // Room for 8, in 16 slots. Every key below has the same home slot, so
+    // most are placed beyond its neighbourhood.
+    CHECK(MAP_INIT(&map, 8));
+    const uintptr_t table = atomic_load(&map.table);
+    const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *t =
+    (const struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *) table;
+    CHECK(t->mask + 1 == 16);
+    for(int n = 0; n < 8; n++)
+    {
+      CHECK(MAP_INSERT(&map, key_of(0, 16 * n), &values[0][n]));
+    }
+    // Refused at one more than it was made for, although slots remain.
+    CHECK(!MAP_INSERT(&map, key_of(0, 16 * 8), &values[0][8]));
+    CHECK(atomic_load(&map.table) == table);
+    for(int n = 0; n < 8; n++)
+    {
+      CHECK(MAP_GET(&map, key_of(0, 16 * n)) == &values[0][n]);
+    }
+    CHECK(MAP_GET(&map, key_of(0, 16 * 8)) == WG14_SIGNALS_NULLPTR);
+    CHECK(MAP_ERASE(&map, key_of(0, 16 * 3)) == &values[0][3]);
+    CHECK(MAP_INSERT(&map, key_of(0, 16 * 8), &values[0][8]));
+    CHECK(MAP_GET(&map, key_of(0, 16 * 8)) == &values[0][8]);
+    MAP_CLEANUP(&map);
+  }
+
+  SECTION("a fixed capacity instance allocates nothing in thread_init()");
+  {
+    struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr) attr = {
+    .create = create_cb, .destroy = destroy_cb, .max_threads = THREADS};
+    CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)(&tls, &attr));
+    const uintptr_t table = atomic_load(&tls->thread_id_to_tls_map.table);
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success == thrd_create(&threads[n], tss_worker,
+                                        WG14_SIGNALS_NULLPTR));
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 0;
+      thrd_join(threads[n], &res);
+      CHECK(res == 0);
+    }
+    CHECK(atomic_load(&tls->thread_id_to_tls_map.table) == table);
+    CHECK(atomic_load(&created) == THREADS);
+    CHECK(0 == WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)(tls));
+  }
+  printf("tss map checks passed\n");
+  return ret;
+}
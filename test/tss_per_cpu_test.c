@@ -0,0 +1,147 @@
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <signal.h>
+#include <stdatomic.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+#define TSS_FOR_EACH WG14_SIGNALS_PREFIX(tss_async_signal_safe_for_each)
+
+// A per-CPU instance has one value per CPU, made at create, whatever the
+// number of threads. Check that threads which never call thread_init() find
+// a value, that counting into the current CPU's value with atomics, from
+// threads and from a signal handler, loses no count however the threads
+// migrate, that for_each() visits every CPU's value, and that the values are
+// destroyed with the instance.
+
+#define THREADS 32
+#define BUMPS 10000
+
+struct counter_t
+{
+  atomic_ullong count;
+};
+
+static TSS tls;
+static atomic_int created;
+static atomic_int destroyed;
+static atomic_int failures;
+
+static int create_cb(void **dest)
+{
+  atomic_fetch_add(&created, 1);
+  atomic_init(&((struct counter_t *) *dest)->count, 0);
+  return 0;
+}
+static int destroy_cb(void *v)
+{
+  (void) v;
+  atomic_fetch_add(&destroyed, 1);
+  return 0;
+}
+
+static void bump(void)
+{
+  struct counter_t *c = (struct counter_t *) TSS_GET(tls);
+  if(c == WG14_SIGNALS_NULLPTR)
+  {
+    atomic_fetch_add(&failures, 1);
+    return;
+  }
+  atomic_fetch_add_explicit(&c->count, 1, memory_order_relaxed);
+}
+
+static void handler(int signo)
+{
+  (void) signo;
+  bump();
+}
+
+static int worker(void *arg)
+{
+  (void) arg;
+  for(int n = 0; n < BUMPS; n++)
+  {
+    bump();
+    if(n % 1000 == 0)
+    {
+      thrd_yield();
+    }
+  }
+  return 0;
+}
+
+static int sum(void *value, void *arg)
+{
+  *(unsigned long long *) arg +=
+  atomic_load(&((struct counter_t *) value)->count);
+  return 0;
+}
+
+static int count_visits(void *value, void *arg)
+{
+  (void) value;
+  ++*(int *) arg;
+  return 0;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb,
+                          .destroy = destroy_cb,
+                          .value_size = sizeof(struct counter_t),
+                          .per_cpu = true};
+  CHECK(0 == TSS_CREATE(&tls, &attr));
+  const int cpus = atomic_load(&created);
+  CHECK(cpus >= 1);
+
+  SECTION("every CPU's value is made at create, and visited");
+  {
+    int visits = 0;
+    CHECK(0 == TSS_FOR_EACH(tls, count_visits, &visits));
+    CHECK(visits == cpus);
+    // Nothing to register.
+    CHECK(0 == TSS_THREAD_INIT(tls));
+    CHECK(atomic_load(&created) == cpus);
+  }
+
+  SECTION("counts from threads and a signal handler are never lost");
+  {
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], worker, WG14_SIGNALS_NULLPTR));
+    }
+    signal(SIGINT, handler);
+    for(int n = 0; n < 100; n++)
+    {
+      raise(SIGINT);
+    }
+    signal(SIGINT, SIG_DFL);
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 1;
+      thrd_join(threads[n], &res);
+      CHECK(res == 0);
+    }
+    unsigned long long total = 0;
+    CHECK(0 == TSS_FOR_EACH(tls, sum, &total));
+    CHECK(total == (unsigned long long) THREADS * BUMPS + 100);
+    CHECK(atomic_load(&failures) == 0);
+    // No thread made a value of its own.
+    CHECK(atomic_load(&created) == cpus);
+  }
+
+  CHECK(0 == TSS_DESTROY(tls));
+  CHECK(atomic_load(&destroyed) == cpus);
+  printf("tss per CPU checks passed (%d CPUs)\n", cpus);
+  return ret;
+}
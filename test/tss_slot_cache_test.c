@@ -0,0 +1,103 @@
+#define _CRT_SECURE_NO_WARNINGS 1
+
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+
+// thread_init() caches the value in a per-thread slot so get() need not look
+// in the instance's map. White-box check (header-only mode makes the
+// instance's map reachable from this TU) that get() is served from the slot
+// even with the map entry gone, that an instance created after another was
+// destroyed never matches its stale slots, and that a thread using more
+// instances than there are slots still gets the right value for each.
+
+#define INSTANCES (WG14_SIGNALS_TSS_CACHE_SLOTS + 3)
+
+static unsigned values[INSTANCES * 2];
+static atomic_int next_value;
+
+static int create_cb(void **dest)
+{
+  *dest = &values[atomic_fetch_add(&next_value, 1)];
+  return 0;
+}
+static int destroy_cb(void *v)
+{
+  (void) v;
+  return 0;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb, .destroy = destroy_cb};
+
+  SECTION("get() is served from the slot cache");
+  {
+    TSS tls = WG14_SIGNALS_NULLPTR;
+    CHECK(0 == TSS_CREATE(&tls, &attr));
+    CHECK(0 == TSS_THREAD_INIT(tls));
+    void *v = TSS_GET(tls);
+    CHECK(v != WG14_SIGNALS_NULLPTR);
+    const uint64_t key = WG14_SIGNALS_PREFIX(my_current_thread_id)();
+    CHECK(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_erase)(
+          &tls->thread_id_to_tls_map, key) == v);
+    CHECK(TSS_GET(tls) == v);
+    // Put it back for destroy() to sweep.
+    CHECK(WG14_SIGNALS_PREFIX(thread_id_to_tls_map_t_insert)(
+    &tls->thread_id_to_tls_map, key, v));
+    CHECK(0 == TSS_DESTROY(tls));
+  }
+
+  SECTION("a later instance never matches a destroyed one's slots");
+  {
+    TSS a = WG14_SIGNALS_NULLPTR, b = WG14_SIGNALS_NULLPTR;
+    CHECK(0 == TSS_CREATE(&a, &attr));
+    CHECK(0 == TSS_THREAD_INIT(a));
+    CHECK(TSS_GET(a) != WG14_SIGNALS_NULLPTR);
+    CHECK(0 == TSS_DESTROY(a));
+    // Likely at the same address as a.
+    CHECK(0 == TSS_CREATE(&b, &attr));
+    CHECK(TSS_GET(b) == WG14_SIGNALS_NULLPTR);
+    CHECK(0 == TSS_DESTROY(b));
+  }
+
+  SECTION("more instances than slots still get their own values");
+  {
+    TSS tls[INSTANCES];
+    void *v[INSTANCES];
+    for(int n = 0; n < INSTANCES; n++)
+    {
+      CHECK(0 == TSS_CREATE(&tls[n], &attr));
+      CHECK(0 == TSS_THREAD_INIT(tls[n]));
+      v[n] = TSS_GET(tls[n]);
+      CHECK(v[n] != WG14_SIGNALS_NULLPTR);
+    }
+    for(int n = 0; n < INSTANCES; n++)
+    {
+      CHECK(TSS_GET(tls[n]) == v[n]);
+      // Re-initialising brings an evicted value back into the cache.
+      CHECK(0 == TSS_THREAD_INIT(tls[n]));
+      CHECK(TSS_GET(tls[n]) == v[n]);
+    }
+    for(int n = 0; n < INSTANCES; n++)
+    {
+      CHECK(0 == TSS_DESTROY(tls[n]));
+    }
+  }
+
+  printf("tss slot cache checks passed\n");
+  return ret;
+}
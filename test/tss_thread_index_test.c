@@ -0,0 +1,138 @@
+#define WG14_SIGNALS_ENABLE_HEADER_ONLY 1
+
+#include "test_common.h"
+
+#include "wg14_signals/tss_async_signal_safe.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define TSS WG14_SIGNALS_PREFIX(tss_async_signal_safe_t)
+#define TSS_ATTR WG14_SIGNALS_PREFIX(tss_async_signal_safe_attr)
+#define TSS_CREATE WG14_SIGNALS_PREFIX(tss_async_signal_safe_create)
+#define TSS_DESTROY WG14_SIGNALS_PREFIX(tss_async_signal_safe_destroy)
+#define TSS_THREAD_INIT WG14_SIGNALS_PREFIX(tss_async_signal_safe_thread_init)
+#define TSS_GET WG14_SIGNALS_PREFIX(tss_async_signal_safe_get)
+#define THREAD_INDEX WG14_SIGNALS_PREFIX(tss_thread_index_cached)
+
+// Each thread using tss_async_signal_safe is given a dense index, which is
+// the low half of its map key. White-box check (header-only mode makes the
+// allocator reachable from this TU) that threads alive at once hold distinct
+// indices packed at the bottom of the range, that each key then sits in its
+// home slot of the map, and that an exited thread's index is reused by the
+// next thread.
+
+#define THREADS 8
+
+static TSS tls;
+static atomic_int failures;
+static uint32_t indices[THREADS];
+// How many threads must hold their indices at once before any may exit.
+static atomic_int arrived;
+static int wait_for;
+
+static int create_cb(void **dest)
+{
+  *dest = &failures;
+  return 0;
+}
+
+static int worker(void *arg)
+{
+  const int me = (int) (intptr_t) arg;
+  if(TSS_THREAD_INIT(tls) != 0 || TSS_GET(tls) != &failures)
+  {
+    return 1;
+  }
+  indices[me] = THREAD_INDEX;
+  // The key's low half is its home slot.
+  struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *mem =
+  (struct WG14_SIGNALS_PREFIX(tss_async_signal_safe_s) *) tls;
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *table =
+  (struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_table_t) *) atomic_load(
+  &mem->thread_id_to_tls_map.table);
+  const uint64_t key = WG14_SIGNALS_PREFIX(my_current_thread_id)();
+  struct WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slot_t) *home =
+  &WG14_SIGNALS_PREFIX(thread_id_to_tls_map_slots)(table)[key & table->mask];
+  if(atomic_load(&home->key) != key)
+  {
+    atomic_fetch_add(&failures, 1);
+  }
+  atomic_fetch_add(&arrived, 1);
+  while(atomic_load(&arrived) < wait_for)
+  {
+    thrd_yield();
+  }
+  return 0;
+}
+
+static int run(int me)
+{
+  thrd_t thr;
+  int res = 1;
+  if(thrd_create(&thr, worker, (void *) (intptr_t) me) != thrd_success)
+  {
+    return 1;
+  }
+  thrd_join(thr, &res);
+  return res;
+}
+
+int main(void)
+{
+  int ret = 0;
+  struct TSS_ATTR attr = {.create = create_cb};
+  CHECK(0 == TSS_CREATE(&tls, &attr));
+  CHECK(THREAD_INDEX == 0);
+  CHECK(0 == TSS_THREAD_INIT(tls));
+  const uint32_t mine = THREAD_INDEX;
+  CHECK(mine != 0);
+
+  SECTION("threads alive at once hold distinct, dense indices");
+  {
+    wait_for = THREADS;
+    thrd_t threads[THREADS];
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(thrd_success ==
+            thrd_create(&threads[n], worker, (void *) (intptr_t) n));
+    }
+    for(int n = 0; n < THREADS; n++)
+    {
+      int res = 1;
+      thrd_join(threads[n], &res);
+      CHECK(res == 0);
+    }
+    wait_for = 0;
+    for(int n = 0; n < THREADS; n++)
+    {
+      CHECK(indices[n] != 0 && indices[n] != mine);
+      // Together with this thread's, no index is left unused below them.
+      CHECK(indices[n] <= THREADS + 1);
+      for(int m = 0; m < n; m++)
+      {
+        CHECK(indices[n] != indices[m]);
+      }
+    }
+    CHECK(atomic_load(&failures) == 0);
+  }
+
+  SECTION("an exited thread's index is reused");
+  {
+    CHECK(run(0) == 0);
+    const uint32_t first = indices[0];
+    for(int n = 1; n < THREADS; n++)
+    {
+      CHECK(run(n) == 0);
+      CHECK(indices[n] == first);
+    }
+    CHECK(atomic_load(&failures) == 0);
+  }
+
+  // Initialising again keeps the index.
+  CHECK(0 == TSS_THREAD_INIT(tls));
+  CHECK(THREAD_INDEX == mine);
+  CHECK(0 == TSS_DESTROY(tls));
+  printf("tss thread index checks passed\n");
+  return ret;
+}